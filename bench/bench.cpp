@@ -0,0 +1,267 @@
+// Banc de mesure par moteur et par forme d'arbre (make bench). Résultats en JSON.
+//
+// Chaque mesure : un passage d'échauffement, puis --reps répétitions chronométrées chacune en bloc
+// (deux lectures d'horloge par lot, pas par requête). On retient le minimum et la médiane ; le débit
+// (éléments/s) et le coût par élément (ns) sont calculés sur la médiane.
+
+#include "Graph.h"
+#include "HldTree.h"
+#include "ItinerariesTest.h"
+#include "OutputBuffer.h"
+#include "Workload.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    Vertex n = 100000;
+    size_t queries = 200000;
+    size_t v1_queries = 1000;  // v1 est en O(n) par requête
+    int reps = 5;
+    int threads = 0;
+    size_t extra_edges_per_vertex = 3;  // densité du graphe pour les MST
+    uint64_t seed = 1;
+    std::vector<TreeShape> shapes = {TreeShape::Path, TreeShape::Star, TreeShape::Random, TreeShape::Caterpillar,
+                                     TreeShape::Balanced};
+    std::string out;
+    std::string tmp_in = "output/bench_input.in";
+};
+
+struct Result {
+    std::string shape, engine, phase;
+    size_t items = 0;
+    std::vector<double> ns;  // une valeur par répétition
+};
+
+/** Empêche le compilateur d'éliminer les requêtes dont le résultat n'est pas utilisé. */
+double g_sink = 0;
+
+void consume(const std::optional<Weight>& r) { g_sink += r ? *r : -1.0; }
+
+template <class Body>
+Result measure(const Options& opt, const char* shape, const char* engine, const char* phase, size_t items,
+               Body&& body) {
+    using Clock = std::chrono::steady_clock;
+    Result r{shape, engine, phase, items, {}};
+    body();
+    for (int i = 0; i < opt.reps; ++i) {
+        auto t0 = Clock::now();
+        body();
+        auto t1 = Clock::now();
+        r.ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    std::cerr << "  " << engine << " / " << phase << " : " << std::fixed << std::setprecision(3)
+              << *std::min_element(r.ns.begin(), r.ns.end()) / 1e6 << " ms\n";
+    return r;
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    const size_t k = v.size() / 2;
+    return v.size() % 2 ? v[k] : (v[k - 1] + v[k]) / 2;
+}
+
+/** Fichier .in (1-indexé) pour mesurer le chargeur complet (mmap, lecture, construction). */
+bool write_input(const std::string& path, Vertex n, const std::vector<Edge>& edges,
+                 const std::vector<std::pair<Vertex, Vertex>>& queries) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    OutputBuffer ob(f);
+    ob.write_int(n);
+    ob.put(' ');
+    ob.write_int(static_cast<long long>(edges.size()));
+    ob.put('\n');
+    for (const auto& [u, v, w] : edges) {
+        ob.write_int(u + 1);
+        ob.put(' ');
+        ob.write_int(v + 1);
+        ob.put(' ');
+        ob.write_int(static_cast<long long>(w));
+        ob.put('\n');
+    }
+    ob.write_int(static_cast<long long>(queries.size()));
+    ob.put('\n');
+    for (const auto& [u, v] : queries) {
+        ob.write_int(u + 1);
+        ob.put(' ');
+        ob.write_int(v + 1);
+        ob.put('\n');
+    }
+    ob.flush();
+    return static_cast<bool>(f);
+}
+
+void bench_shape(const Options& opt, TreeShape shape, std::vector<Result>& results) {
+    const char* s = shape_name(shape);
+    std::cerr << s << " (n = " << opt.n << ")\n";
+    std::vector<Edge> edges = make_tree_edges(shape, opt.n, opt.seed);
+    const auto queries = make_queries(opt.n, opt.queries, opt.seed + 1);
+    const std::vector<std::pair<Vertex, Vertex>> v1_queries(
+        queries.begin(), queries.begin() + static_cast<std::ptrdiff_t>(std::min(opt.v1_queries, queries.size())));
+
+    if (write_input(opt.tmp_in, opt.n, edges, queries)) {
+        results.push_back(measure(opt, s, "loader", "load", edges.size() + queries.size(), [&] {
+            auto t = ItinerariesTest::load_from_file(opt.tmp_in);
+            g_sink += t ? t->graph().num_vertices() : 0;
+        }));
+        std::remove(opt.tmp_in.c_str());
+    }
+
+    {
+        std::vector<Edge> dense = edges;
+        add_random_edges(dense, opt.n, opt.extra_edges_per_vertex * static_cast<size_t>(opt.n), opt.seed + 2);
+        const Graph g = Graph::from_edges(opt.n, dense);
+        results.push_back(measure(opt, s, "kruskal", "build", dense.size(), [&] { g_sink += g.kruskal().num_edges(); }));
+        results.push_back(measure(opt, s, "prim", "build", dense.size(), [&] { g_sink += g.prim(0).num_edges(); }));
+        results.push_back(measure(opt, s, "kruskal_radix", "build", dense.size(),
+                                  [&] { g_sink += g.kruskal_radix().num_edges(); }));
+        results.push_back(measure(opt, s, "prim_radix", "build", dense.size(),
+                                  [&] { g_sink += g.prim_radix(0).num_edges(); }));
+        results.push_back(measure(opt, s, "boruvka", "build", dense.size(),
+                                  [&] { g_sink += g.boruvka(opt.threads).num_edges(); }));
+
+        // Poids modifiables : une mise à jour par arête tirée au hasard, un coup ±10 % (échanges possibles).
+        std::optional<HldTree> hld;
+        results.push_back(measure(opt, s, "hld", "build", dense.size(), [&] { hld = HldTree::from_graph(g); }));
+        results.push_back(measure(opt, s, "hld", "queries", queries.size(), [&] {
+            for (const auto& [u, v] : queries) consume(hld->query(u, v));
+        }));
+        WorkloadRng rng(opt.seed + 3);
+        const size_t n_updates = std::min(queries.size(), dense.size());
+        results.push_back(measure(opt, s, "hld", "updates", n_updates, [&] {
+            for (size_t i = 0; i < n_updates; ++i) {
+                const auto& [u, v, w] = dense[rng.below(dense.size())];
+                g_sink += static_cast<double>(hld->update_edge_weight(u, v, w * (0.9 + 0.2 * rng.unit())));
+            }
+        }));
+    }
+
+    Graph tree = Graph::from_edges(opt.n, edges);
+    edges = std::vector<Edge>();
+
+    results.push_back(measure(opt, s, "v1", "queries", v1_queries.size(), [&] {
+        for (const auto& [u, v] : v1_queries) consume(tree.itineraries_v1(u, v));
+    }));
+
+    results.push_back(measure(opt, s, "v2", "preprocess", static_cast<size_t>(opt.n),
+                              [&] { tree.compute_center_and_parent(); }));
+    results.push_back(measure(opt, s, "v2", "queries", queries.size(), [&] {
+        for (const auto& [u, v] : queries) consume(tree.itineraries_v2(u, v));
+    }));
+    results.push_back(measure(opt, s, "v2", "batch", queries.size(), [&] {
+        for (const auto& r : tree.answer_batch(queries, opt.threads)) consume(r);
+    }));
+    results.push_back(measure(opt, s, "v2", "batch_curve", queries.size(), [&] {
+        for (const auto& r : tree.answer_batch(queries, opt.threads, BatchOrder::Curve)) consume(r);
+    }));
+
+    results.push_back(measure(opt, s, "v3", "preprocess", static_cast<size_t>(opt.n) + queries.size(),
+                              [&] { tree.preprocess_itineraries_v3(queries); }));
+    results.push_back(measure(opt, s, "v3", "queries", queries.size(), [&] {
+        for (const auto& [u, v] : queries) consume(tree.itineraries_v3(u, v));
+    }));
+
+    results.push_back(measure(opt, s, "v4", "preprocess", static_cast<size_t>(opt.n),
+                              [&] { tree.preprocess_itineraries_v4(); }));
+    results.push_back(measure(opt, s, "v4", "queries", queries.size(), [&] {
+        for (const auto& [u, v] : queries) consume(tree.itineraries_v4(u, v));
+    }));
+
+    results.push_back(measure(opt, s, "v5", "preprocess", static_cast<size_t>(opt.n),
+                              [&] { tree.preprocess_itineraries_v5(); }));
+    results.push_back(measure(opt, s, "v5", "queries", queries.size(), [&] {
+        for (const auto& [u, v] : queries) consume(tree.itineraries_v5(u, v));
+    }));
+}
+
+void write_json(std::ostream& out, const Options& opt, const std::vector<Result>& results) {
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"format\": 1,\n  \"config\": {\"n\": " << opt.n << ", \"queries\": " << opt.queries
+        << ", \"v1_queries\": " << opt.v1_queries << ", \"reps\": " << opt.reps << ", \"threads\": " << opt.threads
+        << ", \"extra_edges_per_vertex\": " << opt.extra_edges_per_vertex << ", \"seed\": " << opt.seed << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const double med = median(r.ns);
+        const double lo = *std::min_element(r.ns.begin(), r.ns.end());
+        out << "    {\"shape\": \"" << r.shape << "\", \"engine\": \"" << r.engine << "\", \"phase\": \"" << r.phase
+            << "\", \"items\": " << r.items << ", \"min_ms\": " << lo / 1e6 << ", \"median_ms\": " << med / 1e6
+            << ", \"ns_per_item\": " << (r.items ? med / static_cast<double>(r.items) : 0.0)
+            << ", \"items_per_s\": " << (med > 0 ? static_cast<double>(r.items) * 1e9 / med : 0.0) << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (i + 1 >= argc) return false;
+        const std::string val = argv[++i];
+        if (a == "--n")
+            opt.n = static_cast<Vertex>(std::atoll(val.c_str()));
+        else if (a == "--queries")
+            opt.queries = std::strtoull(val.c_str(), nullptr, 10);
+        else if (a == "--v1-queries")
+            opt.v1_queries = std::strtoull(val.c_str(), nullptr, 10);
+        else if (a == "--reps")
+            opt.reps = std::atoi(val.c_str());
+        else if (a == "--threads")
+            opt.threads = std::atoi(val.c_str());
+        else if (a == "--density")
+            opt.extra_edges_per_vertex = std::strtoull(val.c_str(), nullptr, 10);
+        else if (a == "--seed")
+            opt.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else if (a == "--out")
+            opt.out = val;
+        else if (a == "--shapes") {
+            opt.shapes.clear();
+            std::stringstream ss(val);
+            std::string name;
+            while (std::getline(ss, name, ',')) {
+                auto sh = parse_shape(name);
+                if (!sh) return false;
+                opt.shapes.push_back(*sh);
+            }
+        } else
+            return false;
+    }
+    return opt.n >= 2 && opt.reps >= 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::cerr << "Usage : bench [--n N] [--queries Q] [--v1-queries Q1] [--reps R] [--threads T]\n"
+                     "              [--density D] [--seed S] [--shapes path,star,random,caterpillar,balanced]\n"
+                     "              [--out fichier.json]\n";
+        return 1;
+    }
+    std::vector<Result> results;
+    for (TreeShape shape : opt.shapes) bench_shape(opt, shape, results);
+
+    if (opt.out.empty()) {
+        write_json(std::cout, opt, results);
+    } else {
+        std::ofstream f(opt.out);
+        write_json(f, opt, results);
+        if (!f) {
+            std::cerr << "Échec écriture " << opt.out << "\n";
+            return 1;
+        }
+        std::cerr << "Résultats : " << opt.out << "\n";
+    }
+    std::cerr << "(somme de contrôle " << g_sink << ")\n";
+    return 0;
+}
@@ -0,0 +1,68 @@
+#ifndef COMPACTGRAPH_H_INCLUDED
+#define COMPACTGRAPH_H_INCLUDED
+
+#include "Graph.h"
+#include <vector>
+
+/**
+ * Vue figée d'un Graph au format CSR (compressed sparse row) : tableaux contigus
+ * offset_ / target_ / weight_. Seuls les sommets vivants ont des voisins et les
+ * voisins morts sont filtrés à la construction : les parcours n'appellent plus is_alive().
+ * Les indices de sommets sont ceux du Graph d'origine.
+ */
+class CompactGraph
+{
+public:
+    CompactGraph() = default;
+    explicit CompactGraph(const Graph& g);
+
+    Vertex num_vertices() const { return static_cast<Vertex>(alive_.size()); }
+    /** Nombre d'arêtes (chaque arête une fois en non orienté). */
+    EdgeIndex num_edges() const;
+    bool is_directed() const { return directed_; }
+    bool is_alive(Vertex v) const { return v >= 0 && v < num_vertices() && alive_[static_cast<size_t>(v)] != 0; }
+
+    /** Voisins de u : indices [edge_begin(u), edge_end(u)) dans target() / weight(). */
+    EdgeIndex edge_begin(Vertex u) const { return offset_[static_cast<size_t>(u)]; }
+    EdgeIndex edge_end(Vertex u) const { return offset_[static_cast<size_t>(u) + 1]; }
+    EdgeIndex degree(Vertex u) const { return edge_end(u) - edge_begin(u); }
+    Vertex target(EdgeIndex i) const { return target_[static_cast<size_t>(i)]; }
+    Weight weight(EdgeIndex i) const { return weight_[static_cast<size_t>(i)]; }
+
+    std::vector<Edge> get_edges() const;
+
+    std::vector<Vertex> dfs(Vertex start) const;
+    std::vector<Vertex> bfs(Vertex start) const;
+
+    Graph kruskal() const;
+    Graph prim(Vertex start) const;
+    /**
+     * Borůvka parallèle : à chaque tour, chaque composante choisit son arête sortante minimale
+     * (départage (poids, indice) par min atomique), les unions sont faites séquentiellement, puis
+     * relabel et filtrage des arêtes internes en parallèle. n_threads = 0 : tous les cœurs.
+     * Forêt couvrante si le graphe n'est pas connexe.
+     */
+    Graph boruvka(int n_threads = 0) const;
+
+    /** Vrai si tous les poids sont des entiers de [0, 2^32) : condition des variantes entières ci-dessous. */
+    bool has_integral_weights() const;
+    /**
+     * Kruskal pour poids entiers : enregistrements compacts (poids, u, v) triés par base 2^11 (LSD,
+     * passes limitées aux chiffres du poids max), arrêt dès que la forêt est complète.
+     */
+    Graph kruskal_radix() const;
+    /**
+     * Prim pour poids entiers : tas à seaux (un seau par valeur de poids, résumé bitmap 64-aire) avec
+     * diminution de clé ; chaque sommet est au plus une fois dans le tas. Poids max >= 2^22 : prim().
+     */
+    Graph prim_radix(Vertex start) const;
+
+private:
+    std::vector<EdgeIndex> offset_;
+    std::vector<Vertex> target_;
+    std::vector<Weight> weight_;
+    std::vector<char> alive_;
+    bool directed_ = false;
+};
+
+#endif
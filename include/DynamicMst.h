@@ -0,0 +1,74 @@
+#ifndef DYNAMICMST_H_INCLUDED
+#define DYNAMICMST_H_INCLUDED
+
+#include "Graph.h"
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/**
+ * Forêt couvrante minimale maintenue en ligne par un link-cut tree (arbres splay, chemins préférés).
+ * Chaque arête de la forêt est un nœud portant son poids, relié à ses deux extrémités ; chaque nœud
+ * agrège l'indice du nœud de poids max de son sous-arbre splay. Insérer (u, v, w) lit le max du chemin
+ * u–v et l'échange contre la nouvelle arête si w est plus petit (propriété de cycle) : aucune
+ * reconstruction du MST ni du prétraitement. Requêtes et insertions en O(log n) amorti.
+ */
+class DynamicMst
+{
+public:
+    explicit DynamicMst(Vertex n_vertices = 0);
+    /** Forêt initiale : insère toutes les arêtes de g (sommets vivants). O(m log n). */
+    static DynamicMst from_graph(const Graph& g);
+
+    Vertex num_vertices() const { return n_; }
+    /** Nombre d'arêtes de la forêt courante. */
+    size_t num_edges() const { return edge_count_; }
+    Weight total_weight() const { return total_weight_; }
+
+    /** Ajoute l'arête (u, v, w). Retourne true si la forêt a changé (arête ajoutée ou échangée). */
+    bool insert_edge(Vertex u, Vertex v, Weight w);
+    /** Max des poids sur le chemin u–v de la forêt : même valeur que itineraries_v1 sur le MST. 0 si u = v,
+     *  nullopt si u et v ne sont pas reliés. Non const : les accès restructurent les arbres splay. */
+    std::optional<Weight> query(Vertex u, Vertex v);
+    bool connected(Vertex u, Vertex v);
+
+    /** Arêtes de la forêt courante (u, v, w). */
+    std::vector<Edge> edges() const;
+    Graph to_graph() const { return Graph::from_edges(n_, edges()); }
+
+private:
+    Vertex n_;
+    size_t edge_count_ = 0;
+    Weight total_weight_ = 0;
+    /** Nœud d'arbre splay ; le max agrégé est copié dans le nœud pour que pull ne lise que les enfants. */
+    struct Node {
+        Vertex child[2] = {-1, -1};
+        Vertex parent = -1;       // parent splay, ou parent de chemin si le nœud est racine splay
+        Vertex max_node;          // nœud de poids max du sous-arbre splay
+        Weight value;          // poids propre (lowest pour un sommet)
+        Weight max_value;      // value de max_node
+        bool flip = false;     // inversion en attente (make_root)
+    };
+    // Nœuds 0..n-1 : sommets ; n..2n-2 : arêtes de la forêt.
+    std::vector<Node> nodes_;
+    std::vector<Vertex> edge_u_, edge_v_;  // extrémités, indexées par nœud - n (-1 si libre)
+    std::vector<Vertex> free_edges_;
+
+    bool is_splay_root(Vertex x) const {
+        const Vertex p = nodes_[static_cast<size_t>(x)].parent;
+        return p < 0 || (nodes_[static_cast<size_t>(p)].child[0] != x && nodes_[static_cast<size_t>(p)].child[1] != x);
+    }
+    void pull(Vertex x);
+    void push(Vertex x);
+    void rotate(Vertex x);
+    void splay(Vertex x);
+    void access(Vertex x);
+    void make_root(Vertex x);
+    Vertex find_root(Vertex x);
+    void link(Vertex x, Vertex y);
+    void cut(Vertex x, Vertex y);
+    /** Nœud de poids max sur le chemin u–v, -1 si u et v ne sont pas reliés (deux accès). */
+    Vertex path_max_node(Vertex u, Vertex v);
+};
+
+#endif
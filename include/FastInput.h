@@ -0,0 +1,77 @@
+#ifndef FASTINPUT_H_INCLUDED
+#define FASTINPUT_H_INCLUDED
+
+#include "Graph.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+
+/** Fichier projeté en mémoire en lecture seule (mmap ; lecture complète en repli hors POSIX). */
+class MappedFile
+{
+public:
+    /** sequential : lecture en flux (MADV_SEQUENTIAL) ; sinon accès aléatoire, pages préchargées (MADV_WILLNEED). */
+    static std::optional<MappedFile> open(const std::string& path, bool sequential = true);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    MappedFile() = default;
+    void release();
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::string fallback_;
+};
+
+/**
+ * Lecture de nombres sans locale ni flux : chaque appel saute les blancs puis lit
+ * un entier (boucle sur les chiffres) ou un poids (std::from_chars).
+ * Retourne false en fin de tampon ou sur un jeton invalide.
+ */
+class Scanner
+{
+public:
+    Scanner(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+    /** Entier signé de type Int (int, ou Vertex pour les identifiants de sommets). */
+    template <class Int>
+    bool next_int(Int& x) {
+        skip_blanks();
+        if (p_ == end_) return false;
+        const bool neg = (*p_ == '-');
+        if (neg) ++p_;
+        if (p_ == end_ || static_cast<unsigned>(*p_ - '0') > 9) return false;
+        long long v = 0;
+        while (p_ != end_) {
+            const unsigned d = static_cast<unsigned>(*p_ - '0');
+            if (d > 9) break;
+            v = v * 10 + d;
+            ++p_;
+        }
+        x = static_cast<Int>(neg ? -v : v);
+        return true;
+    }
+
+    bool next_weight(Weight& w);
+    /** Poids brut (mode rang : codé ensuite par WeightCodec ; sinon pour sauter la colonne). */
+    bool next_double(double& x);
+
+private:
+    void skip_blanks() {
+        while (p_ != end_ && static_cast<unsigned char>(*p_) <= ' ') ++p_;
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef FLATPAIRMAP_H_INCLUDED
+#define FLATPAIRMAP_H_INCLUDED
+
+#include "Stats.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Table paire non ordonnée {u, v} → Value à adressage ouvert (sondage linéaire) : un seul tableau de
+ * cases {clé, valeur}, capacité puissance de 2, facteur de charge ≤ 1/2. La clé (min, max) est
+ * mélangée par splitmix64 : les paires structurées (voisins, grilles) ne se concentrent pas sur quelques cases.
+ * Index : type entier des sommets (indices ≥ 0) ; clé sur 64 bits pour des indices de 32 bits au plus,
+ * sur 128 bits au-delà (VERTEX=i64).
+ */
+template <class Index, class Value>
+class FlatPairMap
+{
+    using Key = std::conditional_t<(sizeof(Index) <= 4), uint64_t, unsigned __int128>;
+
+public:
+    void clear() {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    /** Prépare la table pour n clés sans agrandissement. */
+    void reserve(size_t n) {
+        size_t cap = 16;
+        while (cap < 2 * n) cap <<= 1;
+        if (cap > slots_.size()) rehash(cap);
+    }
+
+    void insert_or_assign(Index u, Index v, Value w) {
+        if (2 * (size_ + 1) > slots_.size()) rehash(slots_.empty() ? 16 : 2 * slots_.size());
+        const Key k = key(u, v);
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = hash(k) & mask;; i = (i + 1) & mask) {
+            if (slots_[i].key == k) {
+                slots_[i].value = w;
+                return;
+            }
+            if (slots_[i].key == EMPTY) {
+                slots_[i] = {k, w};
+                ++size_;
+                return;
+            }
+        }
+    }
+
+    /** Valeur associée à {u, v}, nullptr si absente. */
+    const Value* find(Index u, Index v) const {
+        const Key k = key(u, v);
+        if (slots_.empty() || k == EMPTY) return nullptr;
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = hash(k) & mask, probes = 1;; i = (i + 1) & mask, ++probes) {
+            if (slots_[i].key == k || slots_[i].key == EMPTY) {
+                STATS_ADD(HashProbes, probes);
+                return slots_[i].key == k ? &slots_[i].value : nullptr;
+            }
+        }
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+    };
+    /** Aucune paire de sommets valides (indices ≥ 0) ne donne cette clé. */
+    static constexpr Key EMPTY = ~Key{0};
+    static constexpr int HALF = 4 * static_cast<int>(sizeof(Key));
+
+    static Key key(Index u, Index v) {
+        using Half = std::conditional_t<(sizeof(Index) <= 4), uint32_t, uint64_t>;
+        const Half a = static_cast<Half>(u < v ? u : v);
+        const Half b = static_cast<Half>(u < v ? v : u);
+        return (static_cast<Key>(a) << HALF) | b;
+    }
+    static uint64_t hash(Key k) {
+        if constexpr (sizeof(Key) == 8)
+            return mix(k);
+        else
+            return mix(static_cast<uint64_t>(k) ^ mix(static_cast<uint64_t>(k >> 64)));
+    }
+    static uint64_t mix(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old(capacity, Slot{EMPTY, Value{}});
+        old.swap(slots_);
+        const size_t mask = capacity - 1;
+        for (const Slot& s : old) {
+            if (s.key == EMPTY) continue;
+            size_t i = hash(s.key) & mask;
+            while (slots_[i].key != EMPTY) i = (i + 1) & mask;
+            slots_[i] = s;
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+};
+
+#endif
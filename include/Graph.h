@@ -1,35 +1,85 @@
 #ifndef GRAPH_H_INCLUDED
 #define GRAPH_H_INCLUDED
 
+#include "FlatPairMap.h"
+#include "Types.h"
+#include "WeightCodec.h"
 #include <functional>
-#include <unordered_map>
 #include <vector>
 #include <iostream>
 #include <optional>
 #include <string>
 #include <tuple>
 
-using Vertex = int;
-using Weight = double;
-using Edge = std::tuple<Vertex, Vertex, Weight>;
+class CompactGraph;
 
-struct PairHash {
-    std::size_t operator()(const std::pair<Vertex, Vertex>& p) const {
-        const Vertex a = p.first < p.second ? p.first : p.second;
-        const Vertex b = p.first < p.second ? p.second : p.first;
-        return std::size_t(a) * 1000000007ULL + std::size_t(b);
-    }
+/** Case de binary lifting : 2^k-ième ancêtre et max des poids jusqu'à lui, lus ensemble. 16 octets alignés
+ *  (double + int), 8 avec un poids sur 32 bits ou moins : la table rétrécit avec le type de poids. */
+struct alignas(sizeof(Weight) + sizeof(Vertex) > 8 ? 16 : 8) LiftEntry {
+    Weight max;
+    Vertex up;
+};
+
+/**
+ * Ordre d'exécution d'un lot de requêtes v2 : celui des requêtes, ou trié le long d'une courbe en Z sur
+ * les numéros internes (u, v) pour que des requêtes voisines lisent des cases voisines ; les réponses
+ * sont toujours rendues dans l'ordre des requêtes. Auto : tri si les tables sont en préordre, l'arbre
+ * profond (LiftingView::DEEP_LEVELS) et le lot d'au moins SORTED_BATCH_MIN requêtes ; BATCH_ORDER=input|curve
+ * force le choix.
+ */
+enum class BatchOrder { Input, Curve, Auto };
+
+/** Tables de binary lifting en lecture seule (celles d'un Graph ou d'un index projeté en mémoire).
+ *  depth et lift sont indexés par numéro interne ; label traduit un identifiant d'origine en numéro
+ *  interne (nullptr : mêmes numéros, voir TreeLayout). */
+struct LiftingView {
+    const Vertex* depth = nullptr;
+    const LiftEntry* lift = nullptr;
+    const Vertex* label = nullptr;
+    size_t stride = 0;
+    int levels = 0;
+
+    /** À partir de ce nombre de niveaux (profondeur >= 512), préordre et tri des lots paient (voir la doc, 5.8). */
+    static constexpr int DEEP_LEVELS = 10;
+    static constexpr size_t SORTED_BATCH_MIN = 4096;
+
+    const LiftEntry& at(int k, Vertex v) const { return lift[static_cast<size_t>(k) * stride + static_cast<size_t>(v)]; }
+    Vertex internal(Vertex v) const { return label ? label[v] : v; }
+    /** Requête v2 (LCA + max en une passe) sur des identifiants d'origine. Précondition : u et v valides. */
+    std::optional<Weight> bottleneck(Vertex u, Vertex v) const;
+    /** bottleneck sur un lot, 8 (AVX-512) ou 4 (AVX2) requêtes à la fois ; une paire hors bornes ou dont un
+     *  sommet est mort (alive : stride octets) donne nullopt. Voir src/BottleneckBatch.cpp. */
+    void bottleneck_batch(const char* alive, const std::pair<Vertex, Vertex>* queries, size_t count,
+                          std::optional<Weight>* out, BatchOrder order = BatchOrder::Auto) const;
+    /** Ordre retenu par bottleneck_batch pour un lot de count requêtes (Auto résolu). */
+    BatchOrder batch_order(size_t count, BatchOrder order = BatchOrder::Auto) const;
+    /** Noyau retenu pour bottleneck_batch : "avx512", "avx2" ou "scalaire". */
+    static const char* batch_kernel_name();
 };
 
+/**
+ * Numérotation des tables de lifting (depth_, lift_) : Input garde les identifiants de l'entrée,
+ * Preorder renumérote en préordre du DFS depuis le centre, enfant le plus lourd d'abord : un sommet,
+ * son sous-arbre et sa chaîne lourde occupent des cases voisines. La traduction est faite à l'entrée
+ * des requêtes ; parent_ et l'API restent en identifiants d'origine. Auto : Preorder si l'arbre a au
+ * moins LiftingView::DEEP_LEVELS niveaux de lifting, Input sinon.
+ */
+enum class TreeLayout { Input, Preorder, Auto };
+
+/** Auto, ou la valeur de la variable d'environnement LAYOUT ("input", "preorder"), lue une fois. */
+TreeLayout default_tree_layout();
+
 class Graph
 {
 public:
     Graph();
     explicit Graph(std::vector<std::vector<std::pair<Vertex, Weight>>> adj, bool directed);
+    /** Construction en bloc (listes d'adjacence pré-dimensionnées), sans invalidations par arête. */
+    static Graph from_edges(Vertex n_vertices, const std::vector<Edge>& edges, bool directed = false);
 
     Vertex add_vertex();
     void remove_vertex(Vertex v);
-    int num_vertices() const;
+    Vertex num_vertices() const;
     bool is_alive(Vertex v) const;
 
     void add_edge(Vertex u, Vertex v, Weight w = 1);
@@ -38,20 +88,28 @@ public:
     std::vector<Edge> get_edges() const;
 
     bool is_directed() const;
-    int num_edges() const;
+    EdgeIndex num_edges() const;
 
     std::vector<Vertex> dfs(Vertex start) const;
     std::vector<Vertex> bfs(Vertex start) const;
 
+    /** Copie figée au format CSR (voir CompactGraph) pour les parcours en lecture seule. O(n + m). */
+    CompactGraph freeze() const;
+
     Graph kruskal() const;
     Graph prim(Vertex start) const;
+    /** MST par tours de Borůvka parallèles (voir CompactGraph::boruvka). */
+    Graph boruvka(int n_threads = 0) const;
+    /** Variantes pour poids entiers de [0, 2^32) (voir CompactGraph::kruskal_radix / prim_radix). */
+    Graph kruskal_radix() const;
+    Graph prim_radix(Vertex start) const;
 
     std::optional<Weight> itineraries_v1(Vertex u, Vertex v) const;
 
-    void compute_center_and_parent();
+    void compute_center_and_parent(TreeLayout layout = default_tree_layout());
     bool has_center() const;
     Vertex get_center() const;
-    int get_diameter_length() const;
+    Vertex get_diameter_length() const;
     Vertex get_parent(Vertex v) const;
     std::optional<Vertex> lca(Vertex u, Vertex v) const;
     /** Tarjan LCA : O(n + |P|), réponses dans l'ordre des paires. */
@@ -59,9 +117,46 @@ public:
     /** Max sur le chemin u → ancêtre a. Précondition : a ancêtre de u. O(log n). */
     std::optional<Weight> max_on_path_to_ancestor(Vertex u, Vertex a) const;
     std::optional<Weight> itineraries_v2(Vertex u, Vertex v) const;
+    /** En dessous de ce nombre de requêtes par thread, answer_batch réduit le nombre de threads. */
+    static constexpr size_t MIN_QUERIES_PER_THREAD = 4096;
+    /** itineraries_v2 sur un lot : blocs contigus répartis sur n_threads threads du pool partagé
+     *  (ThreadPool, 0 = nombre de cœurs), au plus un par tranche de min_per_thread requêtes ; chaque
+     *  thread écrit sa tranche du vecteur résultat pré-alloué. Aucun état partagé modifié. Des appels
+     *  concurrents depuis plusieurs threads se partagent les threads du pool (file de tâches commune) :
+     *  ils avancent en même temps, mais à n_threads égal chacun dispose de moins de threads que seul ;
+     *  le pool n'a jamais moins de n_threads - 1 threads. */
+    std::vector<std::optional<Weight>> answer_batch(const std::vector<std::pair<Vertex, Vertex>>& queries,
+                                                    int n_threads = 0, BatchOrder order = BatchOrder::Auto,
+                                                    size_t min_per_thread = MIN_QUERIES_PER_THREAD) const;
+    /** Ordre d'exécution retenu par answer_batch pour un lot de count requêtes (Auto résolu). */
+    BatchOrder batch_order(size_t count, BatchOrder order = BatchOrder::Auto) const {
+        return lifting_view().batch_order(count, order);
+    }
 
+    /** Sérialise l'arbre enraciné (centre, parents, profondeurs, lifting) dans un index binaire versionné,
+     *  relu sans reconstruction par TreeIndex::open. Précondition : has_center(). En mode rang, codec
+     *  (ItinerariesTest::codec) est écrit avec l'arbre pour que les réponses relues restent traduisibles. */
+    bool save_index(const std::string& path, const WeightCodec& codec = WeightCodec()) const;
+
+    /** Hors-ligne : un seul DFS itératif (forêt acceptée) avec un union-find pondéré qui garde le max du chemin
+     *  vers le représentant ; chaque requête est répondue à la fin de son LCA. Ne demande ni centre ni lifting. */
     void preprocess_itineraries_v3(const std::vector<std::pair<Vertex, Vertex>>& queries);
+    /** Recherche de la paire dans la table à adressage ouvert : O(1) en moyenne. */
     std::optional<Weight> itineraries_v3(Vertex u, Vertex v) const;
+    /** Réponses v3 dans l'ordre des requêtes passées au dernier preprocess_itineraries_v3 (sans hachage). */
+    const std::vector<std::optional<Weight>>& itineraries_v3_answers() const { return v3_answers_; }
+
+    /** Arbre de reconstruction de Kruskal : chaque union crée un nœud interne portant le poids de l'arête.
+     *  Fonctionne sur un graphe quelconque (pas besoin de MST matérialisé). O(m log m) puis O(n log n). */
+    void preprocess_itineraries_v4();
+    /** Poids du LCA de u et v dans l'arbre de reconstruction. O(log n). */
+    std::optional<Weight> itineraries_v4(Vertex u, Vertex v) const;
+
+    /** Tour eulérien de l'arbre de reconstruction restreint aux feuilles + sparse table (max des poids).
+     *  O(m log m) puis O(n log n). */
+    void preprocess_itineraries_v5();
+    /** Max des poids entre les positions de u et v dans le tour : deux lectures. O(1). */
+    std::optional<Weight> itineraries_v5(Vertex u, Vertex v) const;
 
     void print_graph(std::ostream& out) const;
     void print_summary(std::ostream& out) const;
@@ -74,21 +169,52 @@ public:
 private:
     std::vector<std::vector<std::pair<Vertex, Weight>>> cont;
     std::vector<char> alive;
-    std::vector<int> free_vertices;
+    std::vector<Vertex> free_vertices;
     bool directed;
 
     bool center_valid_ = false;
     Vertex centre_ = -1;
     std::vector<Vertex> parent_;
     std::vector<Weight> parent_edge_weight_;
-    std::vector<int> depth_;
-    std::vector<std::vector<Vertex>> up_;
-    std::vector<std::vector<Weight>> max_up_;
-    int diameter_length_ = -1;
-
-    std::unordered_map<std::pair<Vertex, Vertex>, Weight, PairHash> max_path_table_;
-
-    void build_binary_lifting(int n);
+    std::vector<Vertex> depth_;
+    /** depth_ et lift_ sont en numéros internes (TreeLayout) : label_[v] = numéro de v, order_[x] = sommet
+     *  de numéro x ; vides si les numéros sont ceux de l'entrée. */
+    std::vector<Vertex> label_, order_;
+    /** Tables niveau par niveau, une seule allocation : lift_[k * lift_stride_ + x]. */
+    std::vector<LiftEntry> lift_;
+    size_t lift_stride_ = 0;
+    int lift_levels_ = 0;
+    Vertex diameter_length_ = -1;
+
+    /** v3 : réponses dans l'ordre des requêtes, et table {u, v} → réponse pour les appels à itineraries_v3. */
+    std::vector<std::optional<Weight>> v3_answers_;
+    FlatPairMap<Vertex, Weight> max_path_table_;
+
+    bool krt_valid_ = false;
+    std::vector<Vertex> krt_parent_;
+    std::vector<Weight> krt_weight_;
+    std::vector<Vertex> krt_depth_;
+    std::vector<Vertex> krt_up_;
+    int krt_levels_ = 0;
+
+    bool rmq_valid_ = false;
+    std::vector<Vertex> rmq_pos_;
+    std::vector<Vertex> rmq_comp_;
+    std::vector<Weight> rmq_table_;
+    size_t rmq_stride_ = 0;
+
+    LiftingView lifting_view() const {
+        return {depth_.data(), lift_.data(), label_.empty() ? nullptr : label_.data(), lift_stride_, lift_levels_};
+    }
+    Vertex internal(Vertex v) const { return label_.empty() ? v : label_[static_cast<size_t>(v)]; }
+    Vertex external(Vertex x) const { return order_.empty() ? x : order_[static_cast<size_t>(x)]; }
+    /** Case du niveau k pour le numéro interne x. */
+    const LiftEntry& lift(int k, Vertex x) const {
+        return lift_[static_cast<size_t>(k) * lift_stride_ + static_cast<size_t>(x)];
+    }
+    void build_binary_lifting(const CompactGraph& g, TreeLayout layout);
+    void build_kruskal_tree();
+    void build_kruskal_lifting();
 };
 
 #endif
\ No newline at end of file
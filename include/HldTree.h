@@ -0,0 +1,113 @@
+#ifndef HLDTREE_H_INCLUDED
+#define HLDTREE_H_INCLUDED
+
+#include "FlatPairMap.h"
+#include "Graph.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ * Forêt couvrante minimale décomposée en chaînes lourdes (heavy-light), pour des poids qui changent.
+ * Chaque sommet v porte à la position pos[v] le poids de l'arête parent(v)–v ; un arbre de segments
+ * (max, itératif) couvre ces positions, chaque chaîne lourde y occupant un intervalle contigu. Un
+ * changement de poids est une mise à jour ponctuelle, une requête traverse O(log n) chaînes.
+ * Les arêtes hors forêt sont gardées triées par poids et indexées par extrémité : après un changement,
+ * on vérifie que la forêt reste minimale (propriétés de coupe et de cycle) et on échange au besoin une
+ * arête. Un arbre de la forêt occupe un intervalle de positions ; un échange ne garde pas les sommets
+ * dans l'arbre, donc seul cet intervalle est redécomposé.
+ */
+class HldTree
+{
+public:
+    enum class Update { NotFound, Updated, Swapped };
+
+    /** Forêt de Kruskal de g (sommets vivants), les autres arêtes gardées pour les échanges. O(m log m). */
+    static HldTree from_graph(const Graph& g);
+
+    Vertex num_vertices() const { return n_; }
+    /** Nombre d'arêtes de la forêt courante. */
+    size_t num_edges() const { return tree_edge_count_; }
+    Weight total_weight() const { return total_weight_; }
+    /** Redécompositions d'un arbre de la forêt (une par échange d'arête). */
+    size_t rebuild_count() const { return rebuilds_; }
+
+    /** Max des poids sur le chemin u–v de la forêt : même valeur que DynamicMst::query. 0 si u = v,
+     *  nullopt si u et v ne sont pas reliés. O(log² n). */
+    std::optional<Weight> query(Vertex u, Vertex v) const;
+
+    /**
+     * Nouveau poids w pour l'arête (u, v) (arêtes parallèles : la copie de la forêt si elle existe).
+     * Arête de la forêt : mise à jour ponctuelle en O(log n) ; si le poids augmente, recherche d'une
+     * arête de remplacement (voir replacement_edge), en O(min(k, s + d)).
+     * Arête hors forêt : O(log m) ; si le poids baisse, comparaison au max du chemin u–v en O(log² n).
+     * Un échange (Swapped) redécompose l'arbre concerné : O(t) pour un arbre de t sommets.
+     */
+    Update update_edge_weight(Vertex u, Vertex v, Weight w);
+
+    /** Arêtes de la forêt courante (u, v, w). */
+    std::vector<Edge> edges() const;
+    Graph to_graph() const { return Graph::from_edges(n_, edges()); }
+
+private:
+    struct EdgeRec {
+        Vertex u, v;
+        Weight w;
+        bool in_tree;
+    };
+
+    Vertex n_ = 0;
+    std::vector<EdgeRec> edges_;
+    FlatPairMap<Vertex, EdgeIndex> by_pair_;        // {u, v} → première arête (indice dans edges_)
+    std::vector<EdgeIndex> next_parallel_;          // arête parallèle suivante, -1 en fin de liste
+    std::set<std::pair<Weight, EdgeIndex>> non_tree_;  // arêtes hors forêt, par poids croissant
+    std::vector<EdgeIndex> incident_offset_, incident_;  // CSR : arêtes (indices dans edges_) de chaque sommet
+    std::vector<std::vector<std::pair<Vertex, EdgeIndex>>> tree_adj_;  // forêt : (voisin, indice d'arête)
+    size_t tree_edge_count_ = 0;
+    Weight total_weight_ = 0;
+    size_t rebuilds_ = 0;
+
+    // Décomposition (par arbre, voir decompose) ; parent_edge_[v] : indice dans edges_, -1 pour une racine.
+    std::vector<Vertex> parent_, heavy_, head_, root_;
+    std::vector<Vertex> depth_, pos_, size_;
+    std::vector<EdgeIndex> parent_edge_;
+    std::vector<Vertex> vertex_at_;  // inverse de pos_
+    std::vector<Weight> value_;      // value_[pos[v]] = poids de parent_edge_[v] (lowest pour une racine)
+    std::vector<Vertex> seg_;        // arbre de segments itératif : position du max de chaque nœud
+
+    /** Celle des deux positions (-1 = aucune) dont le poids est le plus grand. */
+    Vertex better(Vertex a, Vertex b) const {
+        if (a < 0) return b;
+        return b >= 0 && value_[static_cast<size_t>(b)] > value_[static_cast<size_t>(a)] ? b : a;
+    }
+    /** Décomposition de toute la forêt. O(n). */
+    void rebuild();
+    /** Décompose l'arbre de racine s sur les positions [first, first + taille) ; ses sommets doivent avoir
+     *  depth_ = -1, size_ = 1, heavy_ = -1. Ne touche pas à seg_. O(taille). */
+    void decompose(Vertex s, Vertex first);
+    /** Recalcule les nœuds de seg_ au-dessus des positions [l, r). O(r - l + log n). */
+    void refresh_range(Vertex l, Vertex r);
+    void set_value(Vertex p, Weight w);
+    /** Position du max sur [l, r), -1 si vide. */
+    Vertex range_max(Vertex l, Vertex r) const;
+    /** Position (donc arête parent_edge_) du max du chemin u–v ; -1 si u = v ou non reliés. */
+    Vertex path_max_pos(Vertex u, Vertex v) const;
+    bool in_subtree(Vertex root, Vertex x) const {
+        return pos_[static_cast<size_t>(x)] >= pos_[static_cast<size_t>(root)] &&
+               pos_[static_cast<size_t>(x)] < pos_[static_cast<size_t>(root)] + size_[static_cast<size_t>(root)];
+    }
+    /**
+     * Arête hors forêt la plus légère (poids, puis indice) de poids < w qui traverse la coupe du sous-arbre
+     * de child, -1 si aucune. Deux parcours menés pas à pas en alternance, arrêtés dès que l'un conclut :
+     * les k arêtes hors forêt de poids dans [old, w) par poids croissant (une arête qui traverse la coupe
+     * pèse au moins old, propriété de cycle avant la mise à jour), et les d arêtes incidentes aux s sommets
+     * du plus petit côté de la coupe (sous-arbre ou reste de l'arbre). O(min(k, s + d)).
+     */
+    EdgeIndex replacement_edge(Vertex child, Weight old, Weight w) const;
+    void swap_edges(EdgeIndex enter, EdgeIndex leave);
+};
+
+#endif
@@ -2,39 +2,93 @@
 #define ITINERARIESTEST_H_INCLUDED
 
 #include "Graph.h"
+#include "WeightCodec.h"
 #include <chrono>
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
 
+class TreeIndex;
+namespace stats {
+class Report;
+}
+
 struct ItinerariesRuntimes {
     double v1_ms = 0;
     double v2_total_ms = 0;
     double v3_total_ms = 0;
+    double v4_total_ms = 0;
+    double v5_total_ms = 0;
     bool timeout = false;
     bool results_identical = false;
 };
 
+struct LoadStats {
+    std::size_t bytes = 0;
+    double parse_ms = 0;   // mmap + lecture des arêtes et des requêtes
+    double build_ms = 0;   // construction du graphe
+    double mst_ms = 0;     // MST si m != n-1 (0 sinon)
+    std::string mst;       // moteur MST utilisé (variable MST) ; vide si l'entrée est déjà un arbre
+    double parse_mb_per_s() const { return parse_ms > 0 ? bytes / 1e3 / parse_ms : 0; }
+};
+
 class ItinerariesTest
 {
 public:
     ItinerariesTest() = default;
     ItinerariesTest(Graph tree, std::vector<std::pair<Vertex, Vertex>> queries);
 
-    /** Format : n m, arêtes u v c (1-indexés), Q, paires de requêtes. */
+    /** Format : n m, arêtes u v c (1-indexés), Q, paires de requêtes. Fichier projeté en mémoire (mmap).
+     *  Si m != n-1, MST par Prim depuis 0 (défaut), Kruskal ou Borůvka parallèle selon MST=prim|kruskal|boruvka ;
+     *  poids tous entiers : Prim et Kruskal passent à prim_radix / kruskal_radix (RADIX=0 : versions à comparaisons).
+     *  Un poids qui ne tient pas dans Weight (négatif ou trop grand pour un type entier, trop de valeurs
+     *  distinctes en mode rang) fait échouer le chargement. */
     static std::optional<ItinerariesTest> load_from_file(const std::string& path);
 
-    const Graph& graph() const { return tree_; }
+    /**
+     * Requêtes seules, pour --load-index : accepte un .in complet (arêtes ignorées) ou un fichier
+     * « Q puis Q paires ». Sommets 1-indexés ramenés à 0..n-1 ; nullopt si hors bornes.
+     */
+    static std::optional<std::vector<std::pair<Vertex, Vertex>>> load_queries_from_file(const std::string& path,
+                                                                                        Vertex n);
+
+    /** Répond aux requêtes avec un index déjà prétraité (v2 sur tableaux projetés) et écrit le .out. */
+    static void run_with_index(const TreeIndex& index, const std::vector<std::pair<Vertex, Vertex>>& queries,
+                               std::ostream& out = std::cout,
+                               const std::optional<std::string>& answers_path = std::nullopt);
+
+    const Graph& graph() const { return *tree_; }
+    /** Arbre partagé en lecture seule (compteur de références) : le détenteur peut le garder ou le passer
+     *  à d'autres threads ; mutable_tree() ne le modifiera jamais, il travaille alors sur sa propre copie. */
+    std::shared_ptr<const Graph> snapshot() const { return tree_; }
+    /** Arbre modifiable (prétraitements). Copie à l'écriture : l'arbre n'est dupliqué que si un snapshot
+     *  est encore détenu ailleurs. À appeler depuis le thread propriétaire du test. */
+    Graph& mutable_tree();
+    /** Libère le graphe lu, gardé si m != n-1 pour que v4 se passe du MST (run_and_compare_times). */
+    void release_input() { input_.reset(); }
     const std::vector<std::pair<Vertex, Vertex>>& queries() const { return queries_; }
+    const LoadStats& load_stats() const { return load_stats_; }
+    /** Valeurs d'origine des poids (table des rangs si WEIGHT=rank8|rank16, conversion directe sinon). */
+    const WeightCodec& codec() const { return codec_; }
+
+    /** Rapport --stats : chaque phase de run_and_compare_times y est ajoutée (nullptr : aucune mesure). */
+    void set_stats(stats::Report* report) { stats_ = report; }
 
+    /** Prétraite l'arbre du test sur place (mutable_tree) : aucune copie si aucun snapshot n'est détenu. */
     void run_and_compare_times(std::ostream& out = std::cout,
                                const std::optional<std::string>& answers_path = std::nullopt,
-                               ItinerariesRuntimes* runtimes_out = nullptr) const;
+                               ItinerariesRuntimes* runtimes_out = nullptr);
 
 private:
-    Graph tree_;
+    std::shared_ptr<Graph> tree_ = std::make_shared<Graph>();
+    std::shared_ptr<Graph> input_;  // graphe lu si m != n-1 (v4 sans MST) ; libéré après v4
     std::vector<std::pair<Vertex, Vertex>> queries_;
+    LoadStats load_stats_;
+    WeightCodec codec_;
+    stats::Report* stats_ = nullptr;
 };
 
 #endif
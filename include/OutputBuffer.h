@@ -0,0 +1,45 @@
+#ifndef OUTPUTBUFFER_H_INCLUDED
+#define OUTPUTBUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * Tampon de sortie réutilisable : les nombres sont formatés par std::to_chars directement
+ * dans le tampon, qui n'est vidé sur le flux qu'en gros blocs (ou par flush()).
+ */
+class OutputBuffer
+{
+public:
+    explicit OutputBuffer(std::ostream& out, std::size_t capacity = std::size_t(1) << 20);
+    ~OutputBuffer();
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void put(char c) {
+        if (len_ == buf_.size()) flush();
+        buf_[len_++] = c;
+    }
+    void write(std::string_view s);
+    void write_int(long long x);
+    /** Équivalent de `out << std::fixed << std::setprecision(precision) << x`. */
+    void write_fixed(double x, int precision);
+    /** Copie brute (format binaire). */
+    void write_bytes(const void* data, std::size_t size);
+
+    void flush();
+
+private:
+    /** Garantit n octets libres (n <= capacité, au moins 512). */
+    void reserve(std::size_t n) {
+        if (buf_.size() - len_ < n) flush();
+    }
+
+    std::ostream& out_;
+    std::vector<char> buf_;
+    std::size_t len_ = 0;
+};
+
+#endif
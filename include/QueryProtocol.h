@@ -0,0 +1,73 @@
+#ifndef QUERYPROTOCOL_H_INCLUDED
+#define QUERYPROTOCOL_H_INCLUDED
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * Protocole binaire du serveur de requêtes (--serve), sur socket Unix locale : ordre d'octets natif.
+ *   requête : RequestHeader puis count × QueryPair (sommets 0-indexés) ;
+ *   réponse : ResponseHeader puis count × double (NaN si aucun chemin ou sommet invalide).
+ * count = 0 est une requête valide (réponse vide) : elle sert à lire n_vertices.
+ * Sommets et n_vertices sur 64 bits quel que soit Vertex : le client n'a pas à connaître la build du serveur.
+ * Version 2 du protocole (magics MPQ2 / MPR2) ; un client de la version 1 (sommets sur 32 bits) reçoit BAD_REQUEST.
+ * Une connexion enchaîne autant de requêtes que voulu ; status != OK ferme la connexion après la réponse.
+ */
+namespace protocol {
+
+constexpr uint32_t REQUEST_MAGIC = 0x3251504du;   // "MPQ2"
+constexpr uint32_t RESPONSE_MAGIC = 0x3252504du;  // "MPR2"
+constexpr uint32_t MAX_BATCH = 1u << 20;
+
+enum Status : uint32_t { OK = 0, BAD_REQUEST = 1 };
+
+struct RequestHeader {
+    uint32_t magic;
+    uint32_t count;
+};
+
+struct QueryPair {
+    int64_t u;
+    int64_t v;
+};
+
+struct ResponseHeader {
+    uint32_t magic;
+    uint32_t count;
+    int64_t n_vertices;
+    uint32_t status;
+    uint32_t unused;
+};
+
+/** Lit exactement size octets ; false sur fin de flux ou erreur. */
+inline bool read_full(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t r = read(fd, p, size);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        size -= static_cast<size_t>(r);
+    }
+    return true;
+}
+
+/** Écrit exactement size octets (MSG_NOSIGNAL : un client parti ne tue pas le processus). */
+inline bool write_full(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t r = send(fd, p, size, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        size -= static_cast<size_t>(r);
+    }
+    return true;
+}
+
+}  // namespace protocol
+
+#endif
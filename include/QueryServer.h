@@ -0,0 +1,21 @@
+#ifndef QUERYSERVER_H_INCLUDED
+#define QUERYSERVER_H_INCLUDED
+
+#include "QueryStream.h"
+#include <atomic>
+#include <string>
+
+/**
+ * Serveur de requêtes sur socket Unix (protocole de QueryProtocol.h). Le fil appelant accepte les
+ * connexions et les confie à n_workers threads ; chacun sert une connexion jusqu'à sa fermeture, en
+ * appelant engine une fois par requête reçue (lot). engine ne lit qu'un arbre ou un index partagé en
+ * lecture seule : il est appelé en parallèle. Au-delà de n_workers clients simultanés, les connexions
+ * attendent qu'un thread se libère.
+ * Les réponses sont envoyées en valeurs d'origine (codec.decode).
+ * Retourne quand stop passe à true (connexions en cours coupées, socket supprimée) ; false si la
+ * socket n'a pas pu être créée. Un fichier existant à socket_path n'est remplacé que si c'est une socket.
+ */
+bool serve_queries(const std::string& socket_path, Vertex n_vertices, const BatchEngine& engine, int n_workers,
+                   const std::atomic<bool>& stop, const WeightCodec& codec = WeightCodec());
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef QUERYSTREAM_H_INCLUDED
+#define QUERYSTREAM_H_INCLUDED
+
+#include "Graph.h"
+#include "WeightCodec.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+/** Répond à un micro-lot : answers a déjà la taille de queries. Appelé une fois par lot (pas par requête). */
+using BatchEngine = std::function<void(const std::vector<std::pair<Vertex, Vertex>>& queries,
+                                       std::vector<std::optional<Weight>>& answers)>;
+
+struct StreamStats {
+    uint64_t queries = 0;
+    uint64_t batches = 0;
+};
+
+/**
+ * Mode flux : lit des lignes « u v » (1-indexées) sur le descripteur in_fd au fil de leur arrivée et écrit
+ * une réponse par ligne sur out (valeur d'origine via codec, arrondie ; -1 si aucun chemin ou ligne
+ * invalide), dans l'ordre.
+ * Trois étages sur trois threads, reliés par des SpscQueue bornées : lecture et analyse (un lot par
+ * read(), au plus max_batch requêtes), réponse (engine), formatage et écriture (thread appelant,
+ * out vidé après chaque lot). Retourne à la fin de l'entrée, une fois toutes les réponses écrites.
+ */
+StreamStats run_query_stream(int in_fd, std::ostream& out, const BatchEngine& engine,
+                             const WeightCodec& codec = WeightCodec(), size_t max_batch = 4096);
+
+#endif
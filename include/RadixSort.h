@@ -0,0 +1,36 @@
+#ifndef RADIXSORT_H_INCLUDED
+#define RADIXSORT_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Chiffres de 11 bits pour le tri par base : 2048 compteurs (16 Ko) restent en cache L1. */
+constexpr int RADIX_BITS = 11;
+
+/**
+ * Tri LSD stable de a selon les bits [first_bit, end_bit) de key(e) (uint64_t), une passe de RADIX_BITS
+ * bits à la fois : comptage, préfixe, recopie dans un tampon échangé avec a. Partagé par les MST entiers
+ * (tri des arêtes par poids) et l'ordre des lots v2 (clé de courbe en Z).
+ */
+template <class T, class Key>
+void radix_sort_lsd(std::vector<T>& a, int first_bit, int end_bit, Key key) {
+    constexpr uint64_t mask = (uint64_t{1} << RADIX_BITS) - 1;
+    std::vector<T> tmp(a.size());
+    std::vector<size_t> count(size_t{1} << RADIX_BITS);
+    for (int shift = first_bit; shift < end_bit; shift += RADIX_BITS) {
+        std::fill(count.begin(), count.end(), 0);
+        for (const T& e : a) ++count[(static_cast<uint64_t>(key(e)) >> shift) & mask];
+        size_t sum = 0;
+        for (size_t& c : count) {
+            const size_t k = c;
+            c = sum;
+            sum += k;
+        }
+        for (const T& e : a) tmp[count[(static_cast<uint64_t>(key(e)) >> shift) & mask]++] = e;
+        a.swap(tmp);
+    }
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SPSCQUEUE_H_INCLUDED
+#define SPSCQUEUE_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/** Attente active courte, puis yield, puis sommeil bref : un étage inactif ne monopolise pas un cœur. */
+class Backoff
+{
+public:
+    void pause() {
+        if (++count_ < 64) return;
+        if (count_ < 1024)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    void reset() { count_ = 0; }
+
+private:
+    unsigned count_ = 0;
+};
+
+/**
+ * File bornée un producteur / un consommateur sans verrou : anneau de capacité puissance de 2,
+ * indices de tête et de queue sur des lignes de cache distinctes ; chaque côté garde une copie de
+ * l'indice de l'autre et ne la relit (acquire) que si la file lui paraît pleine ou vide.
+ */
+template <class T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        slots_.resize(cap);
+        mask_ = cap - 1;
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /** Producteur : false si la file est pleine (value n'est alors pas déplacée). */
+    bool try_push(T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consommateur : false si la file est vide. */
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T value) {
+        Backoff b;
+        while (!try_push(value)) b.pause();
+    }
+
+    T pop() {
+        T out;
+        Backoff b;
+        while (!try_pop(out)) b.pause();
+        return out;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};  // prochain élément à lire (consommateur)
+    size_t tail_cache_ = 0;                    // copie de tail_ côté consommateur
+    alignas(64) std::atomic<size_t> tail_{0};  // prochaine case à écrire (producteur)
+    size_t head_cache_ = 0;                    // copie de head_ côté producteur
+};
+
+#endif
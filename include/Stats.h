@@ -0,0 +1,97 @@
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Compteurs des chemins chauds, sur option. Compilés seulement avec -DITINERARIES_STATS (make STATS=1) :
+ * sinon STATS_ADD ne génère aucun code et n'évalue pas ses arguments. STATS_ADD cumule dans un tableau
+ * propre au thread (une addition, sans atomique ni partage de ligne de cache) ; flush() publie ces cumuls
+ * dans les compteurs globaux du processus (atomiques, ordre relâché). Le pool publie après chaque tâche,
+ * les threads de QueryStream / QueryServer après chaque lot, snapshot() pour le thread appelant.
+ * Les compteurs matériels (perf_event_open, Linux) ne dépendent pas de cette option.
+ */
+namespace stats {
+
+enum Counter : int {
+    LiftJumps,       // cases de binary lifting lues (v2, index)
+    V1Visited,       // sommets empilés par le DFS de v1
+    UfFinds,         // find (Kruskal, Borůvka, Tarjan, v3)
+    UfCompressions,  // liens réécrits par la compression de chemin
+    HeapPushes,      // tas de Prim
+    HeapPops,
+    HashProbes,      // cases lues dans FlatPairMap (v3 par paire, HldTree)
+    AllocCount,      // appels à operator new
+    AllocBytes,
+    NUM_COUNTERS
+};
+
+const char* counter_name(Counter c);
+
+#ifdef ITINERARIES_STATS
+inline constexpr bool enabled = true;
+inline std::atomic<uint64_t> counters[NUM_COUNTERS];
+// Trivial (ni constructeur ni destructeur) : utilisable depuis operator new sans initialisation gardée.
+inline thread_local uint64_t local_counters[NUM_COUNTERS];
+inline void add(Counter c, uint64_t n) { local_counters[c] += n; }
+#define STATS_ADD(counter, n) ::stats::add(::stats::counter, static_cast<uint64_t>(n))
+#else
+inline constexpr bool enabled = false;
+#define STATS_ADD(counter, n) ((void)sizeof(n))
+#endif
+
+/** Publie les cumuls du thread appelant dans les compteurs globaux et les remet à zéro (rien si désactivés). */
+void flush();
+/** Valeurs courantes des compteurs logiciels, après flush() du thread appelant (zéros si désactivés). */
+std::vector<uint64_t> snapshot();
+
+/** Cycles, défauts de cache de dernier niveau et erreurs de prédiction (threads créés pendant la mesure inclus). */
+class HardwareCounters
+{
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    /** false si perf_event_open est refusé (perf_event_paranoid, conteneur) ou hors Linux. */
+    bool available() const { return fds_[0] >= 0; }
+    void start();
+    /** Cycles, LLC misses, branch misses depuis start() (-1 si le compteur n'a pas pu être ouvert). */
+    std::vector<int64_t> stop();
+
+    static const char* name(int i);
+    static constexpr int COUNT = 3;
+
+private:
+    int fds_[COUNT];
+};
+
+/** Rapport par phase : temps, écarts des compteurs logiciels et matériels entre begin() et end(). */
+class Report
+{
+public:
+    void begin(const std::string& phase);
+    void end();
+    void write(std::ostream& out) const;
+
+private:
+    struct Phase {
+        std::string name;
+        double ms = 0;
+        std::vector<uint64_t> counters;
+        std::vector<int64_t> hardware;
+    };
+    HardwareCounters hw_;
+    std::vector<Phase> phases_;
+    std::vector<uint64_t> start_counters_;
+    double start_ms_ = 0;
+};
+
+}  // namespace stats
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef THREADPOOL_H_INCLUDED
+#define THREADPOOL_H_INCLUDED
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Threads persistants partagés par les passes parallèles (answer_batch, Borůvka) : créés à la première
+ * demande, réveillés à chaque appel au lieu d'être recréés. Chaque appel à run dépose son lot de tâches
+ * dans une file commune : des appels concurrents (depuis plusieurs threads) se partagent les threads du
+ * pool au lieu de s'attendre, et chaque appelant exécute aussi ses propres tâches, ce qui garantit
+ * qu'il progresse même si le pool est occupé ailleurs (une tâche peut donc elle-même appeler run).
+ */
+class ThreadPool
+{
+public:
+    /** Instance du processus ; les threads sont joints à la sortie du programme. */
+    static ThreadPool& shared();
+
+    ThreadPool() = default;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    /** Appelle fn(t) pour t dans [0, tasks), réparties entre l'appelant et les threads du pool (au moins
+     *  tasks - 1, créés au besoin) ; revient quand toutes les tâches de cet appel sont finies. */
+    void run(size_t tasks, const std::function<void(size_t)>& fn);
+    /** Threads créés jusqu'ici (l'appelant non compris). */
+    size_t size() const;
+
+private:
+    /** Lot d'un appel à run, sur la pile de l'appelant ; en file tant qu'il reste des tâches à distribuer. */
+    struct Job {
+        const std::function<void(size_t)>* fn;
+        size_t next, tasks, pending;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    std::vector<std::thread> workers_;
+    std::deque<Job*> queue_;
+    bool stop_ = false;
+
+    void worker_loop();
+    /** Prend la tâche suivante de job, l'exécute hors verrou puis la compte comme finie.
+     *  Précondition : lock tient mutex_ et job a une tâche à distribuer. */
+    void run_one(Job& job, std::unique_lock<std::mutex>& lock);
+};
+
+/** Découpe [0, size) en `threads` blocs contigus de `chunk` cases (le dernier plus court) et appelle
+ *  fn(begin, end, t) sur le pool, l'appelant compris. chunk = 0 : ceil(size / threads).
+ *  Mêmes (size, threads, chunk) → mêmes bornes, ce qui permet d'enchaîner comptage et écriture par bloc. */
+template <class Fn>
+void parallel_chunks(size_t size, size_t threads, Fn fn, size_t chunk = 0) {
+    if (threads <= 1) {
+        fn(size_t{0}, size, size_t{0});
+        return;
+    }
+    if (chunk == 0) chunk = (size + threads - 1) / threads;
+    ThreadPool::shared().run(threads, [&](size_t t) {
+        const size_t b = std::min(size, t * chunk);
+        fn(b, std::min(size, b + chunk), t);
+    });
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TREEINDEX_H_INCLUDED
+#define TREEINDEX_H_INCLUDED
+
+#include "FastInput.h"
+#include "Graph.h"
+#include "WeightCodec.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * En-tête de l'index binaire écrit par Graph::save_index (version 3, ordre d'octets natif, 128 octets).
+ * Les tableaux suivent, chacun aligné sur 64 octets, aux positions données par les *_offset :
+ * alive (char[n]), parent (Vertex[n]), parent_edge_weight (Weight[n]), depth (Vertex[n]),
+ * lift (LiftEntry[levels * n], niveau par niveau), puis en mode rang la table des valeurs (double[codec_count]),
+ * puis si l'arbre est renuméroté (TreeLayout::Preorder) la table label (Vertex[n]). alive, parent et
+ * parent_edge_weight sont en identifiants d'origine, depth et lift en numéros internes.
+ * n, centre et diameter_length sont sur 64 bits quel que soit Vertex (VERTEX=i64 : plus de 2^31 sommets).
+ */
+struct TreeIndexHeader {
+    char magic[8];            // "MPITIDX\0"
+    uint32_t version;
+    uint16_t weight_size;     // sizeof(Weight) à l'écriture : refus si le binaire diffère
+    uint16_t vertex_size;     // sizeof(Vertex)
+    uint64_t n;
+    int64_t centre;
+    int64_t diameter_length;
+    int32_t levels;
+    uint32_t weight_kind;     // WeightKind : 0 flottant, 1 entier, 2 rang
+    uint64_t alive_offset;
+    uint64_t parent_offset;
+    uint64_t weight_offset;
+    uint64_t depth_offset;
+    uint64_t lift_offset;
+    uint64_t file_size;
+    uint64_t codec_offset;    // table des rangs (double[codec_count], WEIGHT=rank8|rank16), 0 sinon
+    uint64_t codec_count;
+    uint64_t label_offset;    // identifiant d'origine → numéro interne (Vertex[n]), 0 si aucune renumérotation
+    uint64_t reserved[1];     // à zéro ; place pour un futur tableau sans changer la taille de l'en-tête
+};
+static_assert(sizeof(TreeIndexHeader) == 128, "TreeIndexHeader doit faire 128 octets");
+
+/**
+ * Arbre prétraité relu depuis un index (--load-index) : le fichier est projeté en mémoire et les
+ * requêtes v2 lisent directement les tableaux projetés, sans parser le graphe ni refaire le lifting.
+ */
+class TreeIndex
+{
+public:
+    /** Version écrite ; les versions 1 et 2 (en-tête 32 bits, depth en int) restent lisibles quand
+     *  Vertex est int, la version 1 sans label_offset (champ alors à zéro). */
+    static constexpr uint32_t VERSION = 3;
+    static constexpr size_t ALIGNMENT = 64;
+
+    /** Ouvre et valide l'index : en-tête (magic, version, tailles des types, bornes des tableaux) puis
+     *  contenu (parents, label, profondeurs et ancêtres du lifting dans les bornes et cohérents). O(n · levels). */
+    static std::optional<TreeIndex> open(const std::string& path);
+
+    Vertex num_vertices() const { return static_cast<Vertex>(header_.n); }
+    Vertex get_center() const { return static_cast<Vertex>(header_.centre); }
+    Vertex get_diameter_length() const { return static_cast<Vertex>(header_.diameter_length); }
+    bool is_alive(Vertex v) const { return v >= 0 && v < num_vertices() && alive_[v]; }
+    Vertex parent(Vertex v) const { return parent_[v]; }
+    Weight parent_edge_weight(Vertex v) const { return parent_edge_weight_[v]; }
+    /** Valeurs d'origine des poids (table des rangs relue de l'index, conversion directe sinon). */
+    const WeightCodec& codec() const { return codec_; }
+
+    /** Même réponse que Graph::itineraries_v2 sur le graphe sauvegardé. O(log n). */
+    std::optional<Weight> itineraries_v2(Vertex u, Vertex v) const {
+        if (!is_alive(u) || !is_alive(v) || view_.levels == 0) return std::nullopt;
+        return view_.bottleneck(u, v);
+    }
+    /** itineraries_v2 sur count paires, via le noyau SIMD de LiftingView::bottleneck_batch. */
+    void answer_batch(const std::pair<Vertex, Vertex>* queries, size_t count, std::optional<Weight>* out) const {
+        view_.bottleneck_batch(alive_, queries, count, out);
+    }
+
+private:
+    explicit TreeIndex(MappedFile file) : file_(std::move(file)) {}
+
+    MappedFile file_;
+    TreeIndexHeader header_{};
+    const char* alive_ = nullptr;
+    const Vertex* parent_ = nullptr;
+    const Weight* parent_edge_weight_ = nullptr;
+    LiftingView view_;
+    WeightCodec codec_;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef TYPES_H_INCLUDED
+#define TYPES_H_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+/**
+ * Types des sommets et des poids, choisis à la compilation (make WEIGHT=… VERTEX=…, voir le Makefile) :
+ *   ITINERARIES_WEIGHT_FLOAT / _U32 / _U16 : poids lus tels quels (entiers non signés : bruit entier) ;
+ *   ITINERARIES_WEIGHT_RANK16 / _RANK8    : poids remplacés par leur rang parmi les valeurs distinctes
+ *                                           (WeightCodec), réponses retraduites en sortie ;
+ *   ITINERARIES_VERTEX_I64                : identifiants de sommets sur 64 bits ; nombres de sommets,
+ *                                           profondeurs, positions, indices d'arêtes (EdgeIndex), index
+ *                                           binaire et protocole suivent la même largeur.
+ * Par défaut : Weight = double, Vertex = int. Les moteurs ne font que comparer des poids (max, tri),
+ * jamais d'arithmétique : un type entier rend toutes les comparaisons entières.
+ */
+#if defined(ITINERARIES_WEIGHT_FLOAT)
+using Weight = float;
+#elif defined(ITINERARIES_WEIGHT_U32)
+using Weight = uint32_t;
+#elif defined(ITINERARIES_WEIGHT_U16)
+using Weight = uint16_t;
+#elif defined(ITINERARIES_WEIGHT_RANK16)
+using Weight = uint16_t;
+#define ITINERARIES_WEIGHT_RANK 1
+#elif defined(ITINERARIES_WEIGHT_RANK8)
+using Weight = uint8_t;
+#define ITINERARIES_WEIGHT_RANK 1
+#else
+using Weight = double;
+#define ITINERARIES_WEIGHT_DOUBLE 1
+#endif
+
+#if defined(ITINERARIES_VERTEX_I64)
+using Vertex = int64_t;
+#else
+using Vertex = int;
+#define ITINERARIES_VERTEX_I32 1
+#endif
+
+static_assert(std::is_signed<Vertex>::value, "Vertex doit être signé (-1 marque l'absence de sommet)");
+
+/** Indice d'arête ou de case CSR : plus de 2^31 sommets impliquent plus de 2^31 arêtes, même largeur que Vertex. */
+using EdgeIndex = Vertex;
+
+using Edge = std::tuple<Vertex, Vertex, Weight>;
+
+/** Poids mémorisés sous forme de rangs (WEIGHT=rank8|rank16) : les valeurs d'origine sont dans un WeightCodec. */
+#ifdef ITINERARIES_WEIGHT_RANK
+constexpr bool WEIGHT_IS_RANK = true;
+#else
+constexpr bool WEIGHT_IS_RANK = false;
+#endif
+
+/** Nature du type de poids, enregistrée dans l'index (TreeIndexHeader::weight_kind). */
+enum class WeightKind : uint32_t { Floating = 0, Integer = 1, Rank = 2 };
+constexpr WeightKind WEIGHT_KIND = WEIGHT_IS_RANK ? WeightKind::Rank
+                                   : std::is_floating_point<Weight>::value ? WeightKind::Floating
+                                   : WeightKind::Integer;
+
+/** Égalité de deux poids : exacte pour un type entier, à 1e-12 près pour un flottant. */
+inline bool weights_equal(Weight a, Weight b) {
+    if constexpr (std::is_floating_point<Weight>::value)
+        return std::fabs(a - b) <= static_cast<Weight>(1e-12);
+    else
+        return a == b;
+}
+
+/** Poids entier de [0, 2^32) : condition des MST entiers (CompactGraph::kruskal_radix / prim_radix).
+ *  Les types entiers de Weight (u32, u16, rangs) sont non signés sur 32 bits au plus. Modèle de fonction :
+ *  la branche flottante n'est pas compilée pour un type entier (pas de comparaison w >= 0 toujours vraie). */
+template <typename W>
+inline bool is_integral_weight(W w) {
+    static_assert(std::is_same<W, Weight>::value, "is_integral_weight attend un Weight");
+    if constexpr (std::is_floating_point<W>::value)
+        return w >= 0 && w < static_cast<W>(4294967296.0) && w == std::floor(w);
+    else
+        return sizeof(W) <= 4 && std::is_unsigned<W>::value;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef UNIONFIND_H_INCLUDED
+#define UNIONFIND_H_INCLUDED
+
+#include "Stats.h"
+#include "Types.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/** Union-find (union par rang + compression de chemin), partagé par Kruskal et l'arbre de reconstruction. */
+struct UnionFind {
+    std::vector<Vertex> parent;
+    std::vector<int> rank;  // ≤ log2 n
+    explicit UnionFind(Vertex n) : parent(static_cast<size_t>(n)), rank(static_cast<size_t>(n), 0) {
+        for (Vertex i = 0; i < n; ++i) parent[static_cast<size_t>(i)] = i;
+    }
+    Vertex find(Vertex x) {
+        STATS_ADD(UfFinds, 1);
+        Vertex root = x;
+        while (parent[static_cast<size_t>(root)] != root) root = parent[static_cast<size_t>(root)];
+        // Compression de chemin : tous les sommets parcourus pointent ensuite sur la racine.
+        size_t compressed = 0;
+        while (parent[static_cast<size_t>(x)] != root) {
+            const Vertex next = parent[static_cast<size_t>(x)];
+            parent[static_cast<size_t>(x)] = root;
+            x = next;
+            ++compressed;
+        }
+        STATS_ADD(UfCompressions, compressed);
+        return root;
+    }
+    void unite(Vertex x, Vertex y) {
+        x = find(x), y = find(y);
+        if (x == y) return;
+        if (rank[static_cast<size_t>(x)] < rank[static_cast<size_t>(y)]) std::swap(x, y);
+        parent[static_cast<size_t>(y)] = x;
+        if (rank[static_cast<size_t>(x)] == rank[static_cast<size_t>(y)]) ++rank[static_cast<size_t>(x)];
+    }
+};
+
+#endif
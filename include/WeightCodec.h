@@ -0,0 +1,57 @@
+#ifndef WEIGHTCODEC_H_INCLUDED
+#define WEIGHTCODEC_H_INCLUDED
+
+#include "Types.h"
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Traduction entre les poids lus (double) et le type Weight. Sans table, simple conversion. Avec table
+ * (WEIGHT=rank8|rank16), un poids est le rang de sa valeur parmi les valeurs distinctes triées : l'ordre
+ * est préservé, donc le max d'un chemin en rangs est le rang du max, retraduit par decode.
+ */
+class WeightCodec
+{
+public:
+    WeightCodec() = default;
+
+    /**
+     * Table des valeurs distinctes de values, précédée de 0 : le rang 0 vaut 0, comme la réponse des moteurs
+     * pour u = v. nullopt si une valeur est négative ou si elles ne tiennent pas toutes dans Weight.
+     */
+    static std::optional<WeightCodec> from_values(std::vector<double> values) {
+        values.push_back(0);
+        std::sort(values.begin(), values.end());
+        if (values.front() < 0) return std::nullopt;
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return from_table(std::move(values));
+    }
+    /** Table déjà triée et sans doublons (relue depuis un index). */
+    static std::optional<WeightCodec> from_table(std::vector<double> table) {
+        if constexpr (std::is_integral<Weight>::value)
+            if (table.size() > static_cast<size_t>(std::numeric_limits<Weight>::max()) + 1) return std::nullopt;
+        WeightCodec c;
+        c.table_ = std::move(table);
+        return c;
+    }
+
+    bool empty() const { return table_.empty(); }
+    const std::vector<double>& table() const { return table_; }
+
+    /** Précondition (avec table) : value est l'une des valeurs de la table. */
+    Weight encode(double value) const {
+        if (table_.empty()) return static_cast<Weight>(value);
+        return static_cast<Weight>(std::lower_bound(table_.begin(), table_.end(), value) - table_.begin());
+    }
+    double decode(Weight w) const {
+        return table_.empty() ? static_cast<double>(w) : table_[static_cast<size_t>(w)];
+    }
+
+private:
+    std::vector<double> table_;
+};
+
+#endif
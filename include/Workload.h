@@ -0,0 +1,115 @@
+#ifndef WORKLOAD_H_INCLUDED
+#define WORKLOAD_H_INCLUDED
+
+#include "Graph.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Générateurs de charges synthétiques (bench, outils) : formes d'arbre, arêtes supplémentaires et
+ * requêtes, reproductibles à partir d'une graine. Les arêtes sont émises une par une (callback) :
+ * rien n'est stocké, ce qui permet de produire des entrées plus grandes que la mémoire.
+ */
+
+/** Générateur splitmix64 : rapide, sans état caché, même suite sur toutes les plateformes. */
+struct WorkloadRng {
+    uint64_t state;
+    explicit WorkloadRng(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    /** Entier uniforme dans [0, bound), bound > 0 (méthode multiplicative de Lemire, biais négligeable). */
+    uint64_t below(uint64_t bound) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+    }
+    /** Réel uniforme dans [0, 1). */
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+};
+
+enum class TreeShape { Path, Star, Random, Caterpillar, Balanced };
+
+inline const char* shape_name(TreeShape s) {
+    switch (s) {
+    case TreeShape::Path: return "path";
+    case TreeShape::Star: return "star";
+    case TreeShape::Random: return "random";
+    case TreeShape::Caterpillar: return "caterpillar";
+    case TreeShape::Balanced: return "balanced";
+    }
+    return "?";
+}
+
+inline std::optional<TreeShape> parse_shape(const std::string& name) {
+    for (TreeShape s : {TreeShape::Path, TreeShape::Star, TreeShape::Random, TreeShape::Caterpillar,
+                        TreeShape::Balanced})
+        if (name == shape_name(s)) return s;
+    return std::nullopt;
+}
+
+/**
+ * Émet les n-1 arêtes parent(v)–v (v = 1..n-1) d'un arbre de la forme demandée, parent(v) < v :
+ *   path : v-1 (profondeur n-1) ; star : 0 ; random : arbre récursif aléatoire (profondeur O(log n)) ;
+ *   caterpillar : épine 0..n/2-1, chaque autre sommet accroché à un sommet d'épine au hasard ;
+ *   balanced : arbre binaire complet ((v-1)/2).
+ * emit(u, v) ; les poids sont tirés par l'appelant.
+ */
+template <class Emit>
+void generate_tree(TreeShape shape, Vertex n, WorkloadRng& rng, Emit&& emit) {
+    const Vertex spine = n / 2 > 0 ? n / 2 : 1;
+    for (Vertex v = 1; v < n; ++v) {
+        Vertex p = 0;
+        switch (shape) {
+        case TreeShape::Path: p = v - 1; break;
+        case TreeShape::Star: p = 0; break;
+        case TreeShape::Random: p = static_cast<Vertex>(rng.below(static_cast<uint64_t>(v))); break;
+        case TreeShape::Caterpillar:
+            p = v < spine ? v - 1 : static_cast<Vertex>(rng.below(static_cast<uint64_t>(spine)));
+            break;
+        case TreeShape::Balanced: p = (v - 1) / 2; break;
+        }
+        emit(p, v);
+    }
+}
+
+/** Arbre de la forme demandée, poids entiers uniformes dans [1, max_weight]. */
+inline std::vector<Edge> make_tree_edges(TreeShape shape, Vertex n, uint64_t seed, int max_weight = 1000000) {
+    WorkloadRng rng(seed);
+    std::vector<Edge> edges;
+    edges.reserve(n > 0 ? static_cast<size_t>(n - 1) : 0);
+    generate_tree(shape, n, rng, [&](Vertex u, Vertex v) {
+        edges.emplace_back(u, v, static_cast<Weight>(1 + rng.below(static_cast<uint64_t>(max_weight))));
+    });
+    return edges;
+}
+
+/** Ajoute extra arêtes aléatoires (extrémités distinctes) : graphe connexe à densité réglable pour les MST. */
+inline void add_random_edges(std::vector<Edge>& edges, Vertex n, size_t extra, uint64_t seed, int max_weight = 1000000) {
+    if (n < 2) return;
+    WorkloadRng rng(seed);
+    edges.reserve(edges.size() + extra);
+    for (size_t i = 0; i < extra; ++i) {
+        const Vertex u = static_cast<Vertex>(rng.below(static_cast<uint64_t>(n)));
+        Vertex v = static_cast<Vertex>(rng.below(static_cast<uint64_t>(n - 1)));
+        if (v >= u) ++v;
+        edges.emplace_back(u, v, static_cast<Weight>(1 + rng.below(static_cast<uint64_t>(max_weight))));
+    }
+}
+
+/** count requêtes uniformes (u, v) dans [0, n)². */
+inline std::vector<std::pair<Vertex, Vertex>> make_queries(Vertex n, size_t count, uint64_t seed) {
+    WorkloadRng rng(seed);
+    std::vector<std::pair<Vertex, Vertex>> q(count);
+    for (auto& [u, v] : q) {
+        u = static_cast<Vertex>(rng.below(static_cast<uint64_t>(n)));
+        v = static_cast<Vertex>(rng.below(static_cast<uint64_t>(n)));
+    }
+    return q;
+}
+
+#endif
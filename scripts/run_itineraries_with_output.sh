@@ -1,12 +1,15 @@
 #!/bin/bash
 # Pour chaque tests/itineraries.*.in :
 #   - produit outputItineraries/itineraries.X.out (réponses aux requêtes, une ligne par requête)
-#   - remplit Runtimes/itineraries.X/ avec v1.txt, v2.txt, v3.txt (une ligne par requête ; N/A si une requête > 30 s)
+#   - remplit Runtimes/itineraries.X/ avec v1.txt … v5.txt (une ligne par requête ; N/A si une requête > 30 s)
 # Le programme n'est pas limité en temps (pas de timeout global).
 # Utilise plusieurs cœurs : NPROC tests en parallèle (défaut = nombre de cœurs).
 #   Exemple : NPROC=4 ./scripts/run_itineraries_with_output.sh
 # Plage de tests (optionnel) : START et END = numéros de test (inclus).
 #   Exemple : START=4 END=9 NPROC=6 ./scripts/run_itineraries_with_output.sh  # uniquement tests 4 à 9, 6 en parallèle
+# Format des runtimes (optionnel) : RUNTIMES_FORMAT=binary écrit Runtimes/itineraries.X/runtimes.bin
+#   (colonnes binaires, sans lignes de temps sur la sortie standard) au lieu des vN.txt ;
+#   conversion ultérieure : python3 scripts/runtimes_to_txt.py Runtimes/itineraries.X/runtimes.bin
 # À exécuter depuis la racine du projet (dossier contenant Makefile, tests/, scripts/).
 
 set -e
@@ -20,6 +23,9 @@ NPROC=${NPROC:-$(nproc 2>/dev/null || echo 4)}
 START=${START:-}
 END=${END:-}
 
+# Format des temps par requête : text (défaut) ou binary
+RUNTIMES_FORMAT=${RUNTIMES_FORMAT:-text}
+
 # Créer les dossiers de sortie
 mkdir -p outputItineraries
 mkdir -p Runtimes
@@ -41,6 +47,31 @@ write_query_times() {
     > "$outfile"
 }
 
+# Extraire tous les fichiers de temps (mode texte) depuis un log
+write_runtimes() {
+  local log="$1"
+  local runtime_dir="$2"
+  if [ "$RUNTIMES_FORMAT" != "binary" ]; then
+    write_query_times "$log" "RUNTIME_V1_QUERIES_START" "RUNTIME_V1_QUERIES_END" "$runtime_dir/v1.txt"
+    for v in 2 3 4 5; do
+      grep "^RUNTIME_V${v}_PREPROCESSING " "$log" | awk '{print $2}' > "$runtime_dir/preprocessing_v${v}.txt" || true
+      write_query_times "$log" "RUNTIME_V${v}_QUERIES_START" "RUNTIME_V${v}_QUERIES_END" "$runtime_dir/v${v}.txt"
+    done
+  fi
+  sed -n '/^n = /,/Résultats identiques/p' "$log" | grep -v '^RUNTIME_' > "$runtime_dir/summary.txt" || true
+}
+
+# Lancer le programme (RUNTIMES_BIN positionné en mode binaire)
+run_main() {
+  local infile="$1"
+  local runtime_dir="$2"
+  if [ "$RUNTIMES_FORMAT" = "binary" ]; then
+    RUNTIMES_BIN="$runtime_dir/runtimes.bin" "$MAIN" "$infile" outputItineraries
+  else
+    "$MAIN" "$infile" outputItineraries
+  fi
+}
+
 run_one_test() {
   local infile="$1"
   local base=$(basename "$infile" .in)
@@ -48,13 +79,8 @@ run_one_test() {
   local log=$(mktemp)
   mkdir -p "$runtime_dir"
   echo "  [$$] Début $base"
-  "$MAIN" "$infile" outputItineraries > "$log" 2>&1
-  write_query_times "$log" "RUNTIME_V1_QUERIES_START" "RUNTIME_V1_QUERIES_END" "$runtime_dir/v1.txt"
-  grep '^RUNTIME_V2_PREPROCESSING ' "$log" | awk '{print $2}' > "$runtime_dir/preprocessing_v2.txt" || true
-  write_query_times "$log" "RUNTIME_V2_QUERIES_START" "RUNTIME_V2_QUERIES_END" "$runtime_dir/v2.txt"
-  grep '^RUNTIME_V3_PREPROCESSING ' "$log" | awk '{print $2}' > "$runtime_dir/preprocessing_v3.txt" || true
-  write_query_times "$log" "RUNTIME_V3_QUERIES_START" "RUNTIME_V3_QUERIES_END" "$runtime_dir/v3.txt"
-  sed -n '/^n = /,/Résultats identiques/p' "$log" | grep -v '^RUNTIME_' > "$runtime_dir/summary.txt" || true
+  run_main "$infile" "$runtime_dir" > "$log" 2>&1
+  write_runtimes "$log" "$runtime_dir"
   rm -f "$log"
   echo "  [$$] Fin $base"
 }
@@ -93,17 +119,16 @@ if [ "$NPROC" -le 1 ]; then
     echo "--- $infile ---"
     log=$(mktemp)
     set +e
-    "$MAIN" "$infile" outputItineraries 2>&1 | tee "$log"
+    run_main "$infile" "$runtime_dir" 2>&1 | tee "$log"
     set -e
-    write_query_times "$log" "RUNTIME_V1_QUERIES_START" "RUNTIME_V1_QUERIES_END" "$runtime_dir/v1.txt"
-    grep '^RUNTIME_V2_PREPROCESSING ' "$log" | awk '{print $2}' > "$runtime_dir/preprocessing_v2.txt" || true
-    write_query_times "$log" "RUNTIME_V2_QUERIES_START" "RUNTIME_V2_QUERIES_END" "$runtime_dir/v2.txt"
-    grep '^RUNTIME_V3_PREPROCESSING ' "$log" | awk '{print $2}' > "$runtime_dir/preprocessing_v3.txt" || true
-    write_query_times "$log" "RUNTIME_V3_QUERIES_START" "RUNTIME_V3_QUERIES_END" "$runtime_dir/v3.txt"
-    sed -n '/^n = /,/Résultats identiques/p' "$log" | grep -v '^RUNTIME_' > "$runtime_dir/summary.txt" || true
+    write_runtimes "$log" "$runtime_dir"
     rm -f "$log"
     [ -f "outputItineraries/${base}.out" ] && echo "  -> outputItineraries/${base}.out ($(wc -l < "outputItineraries/${base}.out") lignes)"
-    echo "  -> $runtime_dir/v1.txt, v2.txt, v3.txt"
+    if [ "$RUNTIMES_FORMAT" = "binary" ]; then
+      echo "  -> $runtime_dir/runtimes.bin"
+    else
+      echo "  -> $runtime_dir/v1.txt … v5.txt"
+    fi
   done
 else
   # Mode parallèle : par lots de NPROC tests
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+Convertit un fichier de runtimes binaire (RUNTIMES_BIN, format "ITRT") en fichiers texte
+vN.txt / preprocessing_vN.txt identiques à ceux produits par run_itineraries_with_output.sh.
+Usage: python3 runtimes_to_txt.py Runtimes/itineraries.8/runtimes.bin [-d DOSSIER]
+"""
+
+import argparse
+import math
+import struct
+import sys
+from array import array
+from pathlib import Path
+
+QUERY_TIMEOUT_MS = 30000.0
+
+
+def read_columns(path: Path):
+    """Retourne une liste (nom, prétraitement_ms, total_ms, temps_par_requête)."""
+    data = path.read_bytes()
+    magic, version, n_cols, _ = struct.unpack_from("<4sIII", data, 0)
+    if magic != b"ITRT" or version != 1:
+        raise ValueError(f"{path}: format inconnu")
+    (rows,) = struct.unpack_from("<Q", data, 16)
+    offset = 24
+    headers = []
+    for _ in range(n_cols):
+        name, pre, total = struct.unpack_from("<8sdd", data, offset)
+        headers.append((name.rstrip(b"\0").decode(), pre, total))
+        offset += 24
+    columns = []
+    for name, pre, total in headers:
+        times = array("d")
+        times.frombytes(data[offset:offset + 8 * rows])
+        offset += 8 * rows
+        columns.append((name, pre, total, times))
+    return columns
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("runtimes", type=Path, help="fichier runtimes.bin")
+    parser.add_argument("-d", "--dir", type=Path, default=None, help="dossier de sortie (défaut : celui du .bin)")
+    args = parser.parse_args()
+    out_dir = args.dir or args.runtimes.parent
+    out_dir.mkdir(parents=True, exist_ok=True)
+    try:
+        columns = read_columns(args.runtimes)
+    except (OSError, ValueError, struct.error) as e:
+        print(f"Erreur: {e}", file=sys.stderr)
+        sys.exit(1)
+    for name, pre, _, times in columns:
+        with open(out_dir / f"{name}.txt", "w") as f:
+            for ms in times:
+                f.write("N/A\n" if ms >= QUERY_TIMEOUT_MS else f"{ms:.6f}\n")
+        if not math.isnan(pre):
+            (out_dir / f"preprocessing_{name}.txt").write_text(f"{pre:.6f}\n")
+    print(f"{len(columns)} colonne(s) écrite(s) dans {out_dir}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,327 @@
+// Requêtes v2 par lot : les mêmes sauts que LiftingView::bottleneck, exécutés sur 8 (AVX-512) ou 4 (AVX2)
+// requêtes à la fois. Chaque niveau k devient un gather masqué sur les cases lift[k][·] des voies
+// concernées ; le max des poids est un max vectoriel. Noyau choisi à l'exécution (CPUID), ou forcé par
+// SIMD=scalar|avx2|avx512 ; voies invalides et fin de lot passent par la version scalaire.
+// Weight étant un double, une voie = 64 bits : 8 voies en AVX-512, 4 en AVX2 (et non 16 / 8).
+// Les paires sont validées en identifiants d'origine (alive), puis traduites en numéros internes (label).
+
+#include "Graph.h"
+#include "RadixSort.h"
+#include "Stats.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Noyaux écrits pour Weight = double et Vertex = int (cases de 16 octets) ; autres types : scalaire.
+#if defined(__GNUC__) && defined(__x86_64__) && defined(ITINERARIES_WEIGHT_DOUBLE) && defined(ITINERARIES_VERTEX_I32)
+#include <immintrin.h>
+#define ITINERARIES_X86_KERNELS 1
+#endif
+
+namespace {
+enum class BatchKernel { Scalar, Avx2, Avx512 };
+
+bool valid_pair(const LiftingView& L, const char* alive, Vertex u, Vertex v) {
+    const size_t n = L.stride;
+    return u >= 0 && v >= 0 && static_cast<size_t>(u) < n && static_cast<size_t>(v) < n && alive[u] && alive[v];
+}
+
+void batch_scalar(const LiftingView& L, const char* alive, const std::pair<Vertex, Vertex>* q, size_t count,
+                  std::optional<Weight>* out) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = valid_pair(L, alive, q[i].first, q[i].second) ? L.bottleneck(q[i].first, q[i].second) : std::nullopt;
+}
+
+#ifdef ITINERARIES_X86_KERNELS
+// Une case LiftEntry fait 16 octets : max à l'octet 0, up à l'octet 8. Les gathers prennent des indices
+// en octets (échelle 1) : (k * stride + v) << 4.
+static_assert(sizeof(LiftEntry) == 16 && offsetof(LiftEntry, max) == 0 && offsetof(LiftEntry, up) == 8,
+              "disposition de LiftEntry attendue par les noyaux SIMD");
+
+/** Résultat d'une voie après le noyau : même règle que la fin de LiftingView::bottleneck. */
+std::optional<Weight> lane_result(bool valid, bool same, bool none, double r) {
+    if (!valid || none) return std::nullopt;
+    if (same) return r > 0 ? r : 0;
+    return r;
+}
+
+__attribute__((target("avx512f"))) void batch_avx512(const LiftingView& L, const char* alive,
+                                                     const std::pair<Vertex, Vertex>* q, size_t count,
+                                                     std::optional<Weight>* out) {
+    const char* lift_max = reinterpret_cast<const char*>(L.lift);
+    const char* lift_up = lift_max + 8;
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512d lowest = _mm512_set1_pd(std::numeric_limits<double>::lowest());
+    uint64_t jumps = 0;  // mêmes cases que LiftingView::bottleneck, publiées une fois par appel
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        alignas(32) int32_t uu[8], vv[8];
+        __mmask8 valid = 0;
+        for (int j = 0; j < 8; ++j) {
+            const auto [u, v] = q[i + static_cast<size_t>(j)];
+            const bool ok = valid_pair(L, alive, u, v);
+            uu[j] = ok ? L.internal(u) : 0;
+            vv[j] = ok ? L.internal(v) : 0;
+            valid = static_cast<__mmask8>(valid | (ok << j));
+        }
+        __m512i U = _mm512_cvtepi32_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(uu)));
+        __m512i V = _mm512_cvtepi32_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(vv)));
+        const __m512i DU = _mm512_cvtepi32_epi64(_mm512_mask_i64gather_epi32(_mm256_setzero_si256(), valid, U, L.depth, 4));
+        const __m512i DV = _mm512_cvtepi32_epi64(_mm512_mask_i64gather_epi32(_mm256_setzero_si256(), valid, V, L.depth, 4));
+        valid &= _mm512_cmpge_epi64_mask(DU, zero) & _mm512_cmpge_epi64_mask(DV, zero);
+
+        // u le plus profond ; égalisation des profondeurs par les bits de d, niveau par niveau.
+        const __mmask8 swap = _mm512_cmplt_epi64_mask(DU, DV);
+        const __m512i U0 = U;
+        U = _mm512_mask_blend_epi64(swap, U, V);
+        V = _mm512_mask_blend_epi64(swap, V, U0);
+        const __m512i D = _mm512_abs_epi64(_mm512_sub_epi64(DU, DV));
+        __m512d R = lowest;
+        for (int k = L.levels - 1; k >= 0; --k) {
+            const __mmask8 m = valid & _mm512_test_epi64_mask(D, _mm512_set1_epi64(int64_t{1} << k));
+            if (!m) continue;
+            jumps += static_cast<uint64_t>(__builtin_popcount(m));
+            const __m512i row = _mm512_set1_epi64(static_cast<int64_t>(k) * static_cast<int64_t>(L.stride));
+            const __m512i idx = _mm512_slli_epi64(_mm512_add_epi64(row, U), 4);
+            R = _mm512_max_pd(R, _mm512_mask_i64gather_pd(R, m, idx, lift_max, 1));
+            U = _mm512_cvtepi32_epi64(_mm512_mask_i64gather_epi32(_mm512_cvtepi64_epi32(U), m, idx, lift_up, 1));
+        }
+        const __mmask8 same = valid & _mm512_cmpeq_epi64_mask(U, V);
+        __mmask8 active = valid & static_cast<__mmask8>(~same);
+        jumps += static_cast<uint64_t>(2 * L.levels + 2) * static_cast<uint64_t>(__builtin_popcount(active));
+        for (int k = L.levels - 1; k >= 0 && active; --k) {
+            const __m512i row = _mm512_set1_epi64(static_cast<int64_t>(k) * static_cast<int64_t>(L.stride));
+            const __m512i iu = _mm512_slli_epi64(_mm512_add_epi64(row, U), 4);
+            const __m512i iv = _mm512_slli_epi64(_mm512_add_epi64(row, V), 4);
+            const __m512i upu = _mm512_cvtepi32_epi64(_mm512_mask_i64gather_epi32(_mm256_setzero_si256(), active, iu, lift_up, 1));
+            const __m512i upv = _mm512_cvtepi32_epi64(_mm512_mask_i64gather_epi32(_mm256_setzero_si256(), active, iv, lift_up, 1));
+            const __mmask8 diff = active & _mm512_cmpneq_epi64_mask(upu, upv);
+            if (!diff) continue;
+            R = _mm512_max_pd(R, _mm512_mask_i64gather_pd(R, diff, iu, lift_max, 1));
+            R = _mm512_max_pd(R, _mm512_mask_i64gather_pd(R, diff, iv, lift_max, 1));
+            U = _mm512_mask_blend_epi64(diff, U, upu);
+            V = _mm512_mask_blend_epi64(diff, V, upv);
+        }
+        // Dernier saut : les deux parents (s'ils existent) sont le LCA.
+        const __m512i iu = _mm512_slli_epi64(U, 4);
+        const __m512i iv = _mm512_slli_epi64(V, 4);
+        const __m512i up0 = _mm512_cvtepi32_epi64(_mm512_mask_i64gather_epi32(_mm256_setzero_si256(), active, iu, lift_up, 1));
+        const __mmask8 none = active & _mm512_cmplt_epi64_mask(up0, zero);
+        const __mmask8 last = active & static_cast<__mmask8>(~none);
+        R = _mm512_max_pd(R, _mm512_mask_i64gather_pd(R, last, iu, lift_max, 1));
+        R = _mm512_max_pd(R, _mm512_mask_i64gather_pd(R, last, iv, lift_max, 1));
+
+        alignas(64) double r[8];
+        _mm512_store_pd(r, R);
+        for (int j = 0; j < 8; ++j)
+            out[i + static_cast<size_t>(j)] = lane_result((valid >> j) & 1, (same >> j) & 1, (none >> j) & 1, r[j]);
+    }
+    STATS_ADD(LiftJumps, jumps);
+    batch_scalar(L, alive, q + i, count - i, out + i);
+}
+
+/** 4 × int64 → 4 × int32 (moitiés basses), pour les gathers 32 bits et leurs masques. */
+__attribute__((target("avx2"))) inline __m128i narrow(__m256i x) {
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0)));
+}
+
+__attribute__((target("avx2"))) inline bool any(__m256i m) { return !_mm256_testz_si256(m, m); }
+
+__attribute__((target("avx2"))) void batch_avx2(const LiftingView& L, const char* alive,
+                                                const std::pair<Vertex, Vertex>* q, size_t count,
+                                                std::optional<Weight>* out) {
+    const double* lift_max = reinterpret_cast<const double*>(L.lift);
+    const int* lift_up = reinterpret_cast<const int*>(reinterpret_cast<const char*>(L.lift) + 8);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256d lowest = _mm256_set1_pd(std::numeric_limits<double>::lowest());
+    uint64_t jumps = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        alignas(32) int64_t uu[4], vv[4], ok[4];
+        for (int j = 0; j < 4; ++j) {
+            const auto [u, v] = q[i + static_cast<size_t>(j)];
+            const bool good = valid_pair(L, alive, u, v);
+            uu[j] = good ? L.internal(u) : 0;
+            vv[j] = good ? L.internal(v) : 0;
+            ok[j] = good ? -1 : 0;
+        }
+        __m256i U = _mm256_load_si256(reinterpret_cast<const __m256i*>(uu));
+        __m256i V = _mm256_load_si256(reinterpret_cast<const __m256i*>(vv));
+        __m256i valid = _mm256_load_si256(reinterpret_cast<const __m256i*>(ok));
+        const __m256i DU = _mm256_cvtepi32_epi64(_mm256_mask_i64gather_epi32(_mm_setzero_si128(), L.depth, U, narrow(valid), 4));
+        const __m256i DV = _mm256_cvtepi32_epi64(_mm256_mask_i64gather_epi32(_mm_setzero_si128(), L.depth, V, narrow(valid), 4));
+        valid = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi64(zero, DU), _mm256_cmpgt_epi64(zero, DV)), valid);
+
+        const __m256i swap = _mm256_cmpgt_epi64(DV, DU);
+        const __m256i U0 = U;
+        U = _mm256_blendv_epi8(U, V, swap);
+        V = _mm256_blendv_epi8(V, U0, swap);
+        const __m256i D = _mm256_blendv_epi8(_mm256_sub_epi64(DU, DV), _mm256_sub_epi64(DV, DU), swap);
+        __m256d R = lowest;
+        for (int k = L.levels - 1; k >= 0; --k) {
+            const __m256i bit = _mm256_set1_epi64x(int64_t{1} << k);
+            const __m256i m = _mm256_and_si256(valid, _mm256_cmpeq_epi64(_mm256_and_si256(D, bit), bit));
+            if (!any(m)) continue;
+            jumps += static_cast<uint64_t>(__builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(m))));
+            const __m256i row = _mm256_set1_epi64x(static_cast<int64_t>(k) * static_cast<int64_t>(L.stride));
+            const __m256i idx = _mm256_slli_epi64(_mm256_add_epi64(row, U), 4);
+            R = _mm256_max_pd(R, _mm256_mask_i64gather_pd(R, lift_max, idx, _mm256_castsi256_pd(m), 1));
+            U = _mm256_cvtepi32_epi64(_mm256_mask_i64gather_epi32(narrow(U), lift_up, idx, narrow(m), 1));
+        }
+        const __m256i same = _mm256_and_si256(valid, _mm256_cmpeq_epi64(U, V));
+        const __m256i active = _mm256_andnot_si256(same, valid);
+        jumps += static_cast<uint64_t>(2 * L.levels + 2) *
+                 static_cast<uint64_t>(__builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(active))));
+        for (int k = L.levels - 1; k >= 0 && any(active); --k) {
+            const __m256i row = _mm256_set1_epi64x(static_cast<int64_t>(k) * static_cast<int64_t>(L.stride));
+            const __m256i iu = _mm256_slli_epi64(_mm256_add_epi64(row, U), 4);
+            const __m256i iv = _mm256_slli_epi64(_mm256_add_epi64(row, V), 4);
+            const __m256i upu = _mm256_cvtepi32_epi64(_mm256_mask_i64gather_epi32(_mm_setzero_si128(), lift_up, iu, narrow(active), 1));
+            const __m256i upv = _mm256_cvtepi32_epi64(_mm256_mask_i64gather_epi32(_mm_setzero_si128(), lift_up, iv, narrow(active), 1));
+            const __m256i diff = _mm256_andnot_si256(_mm256_cmpeq_epi64(upu, upv), active);
+            if (!any(diff)) continue;
+            R = _mm256_max_pd(R, _mm256_mask_i64gather_pd(R, lift_max, iu, _mm256_castsi256_pd(diff), 1));
+            R = _mm256_max_pd(R, _mm256_mask_i64gather_pd(R, lift_max, iv, _mm256_castsi256_pd(diff), 1));
+            U = _mm256_blendv_epi8(U, upu, diff);
+            V = _mm256_blendv_epi8(V, upv, diff);
+        }
+        const __m256i iu = _mm256_slli_epi64(U, 4);
+        const __m256i iv = _mm256_slli_epi64(V, 4);
+        const __m256i up0 = _mm256_cvtepi32_epi64(_mm256_mask_i64gather_epi32(_mm_setzero_si128(), lift_up, iu, narrow(active), 1));
+        const __m256i none = _mm256_and_si256(active, _mm256_cmpgt_epi64(zero, up0));
+        const __m256i last = _mm256_andnot_si256(none, active);
+        R = _mm256_max_pd(R, _mm256_mask_i64gather_pd(R, lift_max, iu, _mm256_castsi256_pd(last), 1));
+        R = _mm256_max_pd(R, _mm256_mask_i64gather_pd(R, lift_max, iv, _mm256_castsi256_pd(last), 1));
+
+        alignas(32) double r[4];
+        _mm256_store_pd(r, R);
+        const int valid_bits = _mm256_movemask_pd(_mm256_castsi256_pd(valid));
+        const int same_bits = _mm256_movemask_pd(_mm256_castsi256_pd(same));
+        const int none_bits = _mm256_movemask_pd(_mm256_castsi256_pd(none));
+        for (int j = 0; j < 4; ++j)
+            out[i + static_cast<size_t>(j)] =
+                lane_result((valid_bits >> j) & 1, (same_bits >> j) & 1, (none_bits >> j) & 1, r[j]);
+    }
+    STATS_ADD(LiftJumps, jumps);
+    batch_scalar(L, alive, q + i, count - i, out + i);
+}
+#endif
+
+BatchKernel select_kernel() {
+    bool avx2 = false, avx512 = false;
+#ifdef ITINERARIES_X86_KERNELS
+    __builtin_cpu_init();
+    avx2 = __builtin_cpu_supports("avx2");
+    avx512 = __builtin_cpu_supports("avx512f");
+#endif
+    // Par défaut : AVX-512 si disponible, sinon scalaire. Le noyau AVX2 (4 voies) n'a pas battu la boucle
+    // scalaire à la mesure (égal sur tables en cache, plus lent au-delà) : il n'est pris que sur SIMD=avx2.
+    // Un noyau demandé mais non supporté retombe sur le choix par défaut.
+    const char* forced = std::getenv("SIMD");
+    const std::string f = forced ? forced : "";
+    if (f == "scalar") return BatchKernel::Scalar;
+    if (f == "avx2" && avx2) return BatchKernel::Avx2;
+    return avx512 ? BatchKernel::Avx512 : BatchKernel::Scalar;
+}
+
+BatchKernel kernel() {
+    static const BatchKernel k = select_kernel();
+    return k;
+}
+
+void run_kernel(const LiftingView& L, const char* alive, const std::pair<Vertex, Vertex>* queries, size_t count,
+                std::optional<Weight>* out) {
+    switch (kernel()) {
+#ifdef ITINERARIES_X86_KERNELS
+    case BatchKernel::Avx512: batch_avx512(L, alive, queries, count, out); return;
+    case BatchKernel::Avx2: batch_avx2(L, alive, queries, count, out); return;
+#endif
+    default: batch_scalar(L, alive, queries, count, out); return;
+    }
+}
+
+/** Bits de x (32 bits bas) intercalés avec des zéros : bit i → bit 2i. */
+uint64_t spread_bits(uint64_t x) {
+    x &= 0xffffffffull;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+/** Bits de clé gardés pour le tri : deux passes de RADIX_BITS. Au-delà de 2^22 cases de la courbe, des
+ *  requêtes voisines lisent déjà les mêmes lignes de cache ; affiner ne ferait qu'ajouter des passes. */
+constexpr int ORDER_KEY_BITS = 2 * RADIX_BITS;
+
+/** Indices des requêtes dans l'ordre de la courbe en Z (Morton) sur (numéro interne min, max), chaque
+ *  numéro réduit à ses ORDER_KEY_BITS / 2 bits de poids fort ; tri LSD stable sur des mots
+ *  (clé << 32 | indice). Paires invalides en dernier. */
+std::vector<uint32_t> curve_order(const LiftingView& L, const char* alive, const std::pair<Vertex, Vertex>* q,
+                                  size_t count) {
+    int bits = 0;
+    while ((size_t{1} << bits) < L.stride) ++bits;
+    const int drop = std::max(0, bits - ORDER_KEY_BITS / 2);
+    const uint64_t last = (uint64_t{1} << ORDER_KEY_BITS) - 1;
+    std::vector<uint64_t> a(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = last;
+        if (valid_pair(L, alive, q[i].first, q[i].second)) {
+            // Requête symétrique : (min, max) replie le carré sur un triangle.
+            const uint64_t x = static_cast<uint64_t>(L.internal(q[i].first)) >> drop;
+            const uint64_t y = static_cast<uint64_t>(L.internal(q[i].second)) >> drop;
+            key = spread_bits(std::max(x, y)) << 1 | spread_bits(std::min(x, y));
+        }
+        a[i] = key << 32 | i;
+    }
+    radix_sort_lsd(a, 32, 32 + ORDER_KEY_BITS, [](uint64_t e) { return e; });
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(a[i]);
+    return order;
+}
+}  // namespace
+
+const char* LiftingView::batch_kernel_name() {
+    switch (kernel()) {
+    case BatchKernel::Avx512: return "avx512";
+    case BatchKernel::Avx2: return "avx2";
+    case BatchKernel::Scalar: break;
+    }
+    return "scalaire";
+}
+
+BatchOrder LiftingView::batch_order(size_t count, BatchOrder order) const {
+    if (order != BatchOrder::Auto) return order;
+    static const char* forced = std::getenv("BATCH_ORDER");
+    if (forced && std::strcmp(forced, "input") == 0) return BatchOrder::Input;
+    if (forced && std::strcmp(forced, "curve") == 0) return BatchOrder::Curve;
+    // Le tri ne rapproche des cases que si les numéros suivent l'arbre (préordre) ; sur un arbre peu
+    // profond, les sauts sont trop peu nombreux pour amortir clés, tri et recopies (mesures : doc, 5.8).
+    return label && levels >= DEEP_LEVELS && count >= SORTED_BATCH_MIN ? BatchOrder::Curve : BatchOrder::Input;
+}
+
+void LiftingView::bottleneck_batch(const char* alive, const std::pair<Vertex, Vertex>* queries, size_t count,
+                                   std::optional<Weight>* out, BatchOrder order) const {
+    if (levels == 0) {
+        for (size_t i = 0; i < count; ++i) out[i] = std::nullopt;
+        return;
+    }
+    if (batch_order(count, order) != BatchOrder::Curve || count < 2) {
+        run_kernel(*this, alive, queries, count, out);
+        return;
+    }
+    // Requêtes recopiées dans l'ordre de la courbe, réponses replacées à leur indice d'origine.
+    const std::vector<uint32_t> perm = curve_order(*this, alive, queries, count);
+    std::vector<std::pair<Vertex, Vertex>> sorted(count);
+    for (size_t i = 0; i < count; ++i) sorted[i] = queries[perm[i]];
+    std::vector<std::optional<Weight>> answers(count);
+    run_kernel(*this, alive, sorted.data(), count, answers.data());
+    for (size_t i = 0; i < count; ++i) out[perm[i]] = answers[i];
+}
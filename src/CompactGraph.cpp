@@ -0,0 +1,446 @@
+#include "CompactGraph.h"
+#include "RadixSort.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stack>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+/** En dessous de ce nombre d'arêtes par thread, une passe de Borůvka reste sur l'appelant. */
+constexpr size_t MIN_EDGES_PER_THREAD = 1 << 16;
+
+/** Au-delà, un seau par valeur de poids coûte trop de mémoire : prim_radix revient à prim. */
+constexpr uint32_t MAX_BUCKET_WEIGHT = 1u << 22;
+
+struct PackedEdge {
+    uint32_t w;
+    Vertex u, v;
+};
+
+/** Tri stable par w ; seules les passes couvrant les bits de max_w sont faites (2 pour w < 2^22). */
+void radix_sort_by_weight(std::vector<PackedEdge>& a, uint32_t max_w) {
+    int bits = 0;
+    while (bits < 32 && (max_w >> bits) != 0) ++bits;
+    radix_sort_lsd(a, 0, bits, [](const PackedEdge& e) { return e.w; });
+}
+
+/**
+ * File de priorité à clés entières [0, max_key] : une liste doublement chaînée par seau et une pile de
+ * bitmaps (niveau 0 : un bit par seau non vide, niveau l+1 : un bit par mot non nul du niveau l), d'où
+ * le seau minimal en un ctz par niveau. Insertion, diminution de clé et extraction en O(log_64 max_key) ;
+ * contrairement à un tas radix, les clés extraites n'ont pas à être croissantes (Prim).
+ */
+class BucketHeap
+{
+public:
+    BucketHeap(Vertex n, uint32_t max_key)
+        : key_(static_cast<size_t>(n)), next_(static_cast<size_t>(n), -1), prev_(static_cast<size_t>(n), -1),
+          in_(static_cast<size_t>(n), 0), head_(static_cast<size_t>(max_key) + 1, -1) {
+        size_t words = head_.size();
+        do {
+            words = (words + 63) / 64;
+            bits_.emplace_back(words, 0);
+        } while (words > 1);
+    }
+
+    bool empty() const { return bits_.back()[0] == 0; }
+    bool contains(Vertex x) const { return in_[static_cast<size_t>(x)] != 0; }
+    uint32_t key(Vertex x) const { return key_[static_cast<size_t>(x)]; }
+
+    /** Insère x avec la clé k, ou déplace x s'il est déjà présent. */
+    void push(Vertex x, uint32_t k) {
+        if (contains(x)) unlink(x);
+        const size_t b = k;
+        key_[static_cast<size_t>(x)] = k;
+        in_[static_cast<size_t>(x)] = 1;
+        prev_[static_cast<size_t>(x)] = -1;
+        next_[static_cast<size_t>(x)] = head_[b];
+        if (head_[b] >= 0) {
+            prev_[static_cast<size_t>(head_[b])] = x;
+        } else {
+            for (size_t l = 0, i = b; l < bits_.size(); ++l, i /= 64) {
+                const uint64_t was = bits_[l][i / 64];
+                bits_[l][i / 64] = was | (uint64_t{1} << (i % 64));
+                if (was != 0) break;
+            }
+        }
+        head_[b] = x;
+    }
+
+    Vertex pop_min() {
+        size_t b = 0;
+        for (size_t l = bits_.size(); l-- > 0;)
+            b = b * 64 + static_cast<size_t>(__builtin_ctzll(bits_[l][b]));
+        const Vertex x = head_[b];
+        unlink(x);
+        return x;
+    }
+
+private:
+    std::vector<uint32_t> key_;
+    std::vector<Vertex> next_, prev_;
+    std::vector<char> in_;
+    std::vector<Vertex> head_;
+    std::vector<std::vector<uint64_t>> bits_;
+
+    void unlink(Vertex x) {
+        const size_t b = key_[static_cast<size_t>(x)];
+        const Vertex p = prev_[static_cast<size_t>(x)], nx = next_[static_cast<size_t>(x)];
+        if (nx >= 0) prev_[static_cast<size_t>(nx)] = p;
+        if (p >= 0) {
+            next_[static_cast<size_t>(p)] = nx;
+        } else {
+            head_[b] = nx;
+            if (nx < 0) {
+                for (size_t l = 0, i = b; l < bits_.size(); ++l, i /= 64) {
+                    bits_[l][i / 64] &= ~(uint64_t{1} << (i % 64));
+                    if (bits_[l][i / 64] != 0) break;
+                }
+            }
+        }
+        in_[static_cast<size_t>(x)] = 0;
+    }
+};
+}  // namespace
+
+CompactGraph::CompactGraph(const Graph& g)
+    : offset_(static_cast<size_t>(g.num_vertices()) + 1, 0),
+      alive_(static_cast<size_t>(g.num_vertices()), 0),
+      directed_(g.is_directed()) {
+    const Vertex n = g.num_vertices();
+    for (Vertex u = 0; u < n; ++u) {
+        if (!g.is_alive(u)) continue;
+        alive_[static_cast<size_t>(u)] = 1;
+        EdgeIndex deg = 0;
+        for (const auto& p : g.neighbors(u))
+            if (g.is_alive(p.first)) ++deg;
+        offset_[static_cast<size_t>(u) + 1] = deg;
+    }
+    for (Vertex u = 0; u < n; ++u)
+        offset_[static_cast<size_t>(u) + 1] += offset_[static_cast<size_t>(u)];
+    target_.resize(static_cast<size_t>(offset_.back()));
+    weight_.resize(static_cast<size_t>(offset_.back()));
+    for (Vertex u = 0; u < n; ++u) {
+        if (!alive_[static_cast<size_t>(u)]) continue;
+        size_t i = static_cast<size_t>(offset_[static_cast<size_t>(u)]);
+        for (const auto& [v, w] : g.neighbors(u)) {
+            if (!g.is_alive(v)) continue;
+            target_[i] = v;
+            weight_[i] = w;
+            ++i;
+        }
+    }
+}
+
+EdgeIndex CompactGraph::num_edges() const {
+    const EdgeIndex n = static_cast<EdgeIndex>(target_.size());
+    return directed_ ? n : n / 2;
+}
+
+std::vector<Edge> CompactGraph::get_edges() const {
+    std::vector<Edge> out;
+    out.reserve(static_cast<size_t>(num_edges()));
+    for (Vertex u = 0; u < num_vertices(); ++u) {
+        for (EdgeIndex i = edge_begin(u); i < edge_end(u); ++i) {
+            const Vertex v = target(i);
+            if (directed_ || u <= v)
+                out.emplace_back(u, v, weight(i));
+        }
+    }
+    return out;
+}
+
+std::vector<Vertex> CompactGraph::dfs(Vertex start) const {
+    assert(is_alive(start));
+    std::vector<Vertex> order;
+    std::vector<char> visited(static_cast<size_t>(num_vertices()), 0);
+    std::stack<Vertex, std::vector<Vertex>> st;
+    st.push(start);
+    visited[static_cast<size_t>(start)] = 1;
+    while (!st.empty()) {
+        Vertex u = st.top();
+        st.pop();
+        order.push_back(u);
+        for (EdgeIndex i = edge_begin(u); i < edge_end(u); ++i) {
+            const Vertex v = target(i);
+            if (visited[static_cast<size_t>(v)]) continue;
+            visited[static_cast<size_t>(v)] = 1;
+            st.push(v);
+        }
+    }
+    return order;
+}
+
+std::vector<Vertex> CompactGraph::bfs(Vertex start) const {
+    assert(is_alive(start));
+    std::vector<Vertex> order;
+    order.reserve(static_cast<size_t>(num_vertices()));
+    std::vector<char> visited(static_cast<size_t>(num_vertices()), 0);
+    order.push_back(start);
+    visited[static_cast<size_t>(start)] = 1;
+    // order sert aussi de file : les sommets y entrent dans l'ordre de découverte.
+    for (size_t head = 0; head < order.size(); ++head) {
+        const Vertex u = order[head];
+        for (EdgeIndex i = edge_begin(u); i < edge_end(u); ++i) {
+            const Vertex v = target(i);
+            if (visited[static_cast<size_t>(v)]) continue;
+            visited[static_cast<size_t>(v)] = 1;
+            order.push_back(v);
+        }
+    }
+    return order;
+}
+
+Graph CompactGraph::kruskal() const {
+    assert(!directed_ && "Kruskal exige un graphe non orienté");
+    std::vector<Edge> edges = get_edges();
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge& a, const Edge& b) { return std::get<2>(a) < std::get<2>(b); });
+    UnionFind uf(num_vertices());
+    std::vector<Edge> mst;
+    for (const Edge& e : edges) {
+        Vertex u = std::get<0>(e), v = std::get<1>(e);
+        if (uf.find(u) != uf.find(v)) {
+            uf.unite(u, v);
+            mst.push_back(e);
+        }
+    }
+    return Graph::from_edges(num_vertices(), mst);
+}
+
+Graph CompactGraph::prim(Vertex start) const {
+    assert(!directed_ && "Prim exige un graphe non orienté");
+    assert(is_alive(start));
+    using E = std::tuple<Weight, Vertex, Vertex>;
+    std::priority_queue<E, std::vector<E>, std::greater<E>> pq;
+    std::vector<char> in_mst(static_cast<size_t>(num_vertices()), 0);
+    std::vector<Edge> mst;
+    in_mst[static_cast<size_t>(start)] = 1;
+    for (EdgeIndex i = edge_begin(start); i < edge_end(start); ++i)
+        pq.emplace(weight(i), start, target(i));
+    uint64_t pushes = static_cast<uint64_t>(edge_end(start) - edge_begin(start)), pops = 0;
+    while (!pq.empty()) {
+        auto [w, from, to] = pq.top();
+        pq.pop();
+        ++pops;
+        if (in_mst[static_cast<size_t>(to)]) continue;
+        in_mst[static_cast<size_t>(to)] = 1;
+        mst.emplace_back(from, to, w);
+        for (EdgeIndex i = edge_begin(to); i < edge_end(to); ++i) {
+            const Vertex v = target(i);
+            if (!in_mst[static_cast<size_t>(v)]) {
+                pq.emplace(weight(i), to, v);
+                ++pushes;
+            }
+        }
+    }
+    STATS_ADD(HeapPushes, pushes);
+    STATS_ADD(HeapPops, pops);
+    return Graph::from_edges(num_vertices(), mst);
+}
+
+Graph CompactGraph::boruvka(int n_threads) const {
+    assert(!directed_ && "Borůvka exige un graphe non orienté");
+    const Vertex n = num_vertices();
+    // Arêtes d'origine (chaque arête une fois) ; la liste de travail porte les étiquettes des composantes
+    // des extrémités, mises à jour au filtrage : la sélection ne fait aucune indirection.
+    std::vector<Edge> edges;
+    for (Vertex u = 0; u < n; ++u)
+        for (EdgeIndex i = edge_begin(u); i < edge_end(u); ++i)
+            if (target(i) > u) edges.emplace_back(u, target(i), weight(i));
+    std::vector<Vertex> cu(edges.size()), cv(edges.size());
+    std::vector<Weight> ew(edges.size());
+    // Indices d'arêtes non signés pour les min atomiques ; NONE n'est l'indice d'aucune arête.
+    using EdgeId = std::make_unsigned_t<EdgeIndex>;
+    std::vector<EdgeId> eid(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        std::tie(cu[i], cv[i], ew[i]) = edges[i];
+        eid[i] = static_cast<EdgeId>(i);
+    }
+    if (n_threads <= 0) n_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    constexpr EdgeId NONE = std::numeric_limits<EdgeId>::max();
+    std::vector<std::atomic<EdgeId>> best(static_cast<size_t>(n));
+    for (auto& b : best) b.store(NONE, std::memory_order_relaxed);
+    std::vector<Vertex> relabel(static_cast<size_t>(n));
+    std::vector<Vertex> labels;  // étiquettes des composantes actives (racines union-find)
+    for (Vertex v = 0; v < n; ++v)
+        if (is_alive(v)) labels.push_back(v);
+    UnionFind uf(n);
+    std::vector<Edge> mst;
+    mst.reserve(static_cast<size_t>(std::max<Vertex>(0, n - 1)));
+
+    while (!cu.empty()) {
+        const size_t m = cu.size();
+        const size_t threads = std::max<size_t>(1, std::min(static_cast<size_t>(n_threads), m / MIN_EDGES_PER_THREAD));
+
+        // 1. Arête minimale sortant de chaque composante : ordre total (poids, indice), donc pas de cycle.
+        auto lighter = [&](EdgeId a, EdgeId b) { return ew[a] < ew[b] || (ew[a] == ew[b] && a < b); };
+        auto offer = [&](Vertex c, EdgeId e) {
+            std::atomic<EdgeId>& slot = best[static_cast<size_t>(c)];
+            EdgeId cur = slot.load(std::memory_order_relaxed);
+            while ((cur == NONE || lighter(e, cur)) &&
+                   !slot.compare_exchange_weak(cur, e, std::memory_order_relaxed)) {
+            }
+        };
+        parallel_chunks(m, threads, [&](size_t b, size_t e, size_t) {
+            for (size_t i = b; i < e; ++i) {
+                offer(cu[i], static_cast<EdgeId>(i));
+                offer(cv[i], static_cast<EdgeId>(i));
+            }
+        });
+
+        // 2. Unions séquentielles (une arête choisie par ses deux extrémités n'est ajoutée qu'une fois).
+        for (Vertex c : labels) {
+            const EdgeId e = best[static_cast<size_t>(c)].exchange(NONE, std::memory_order_relaxed);
+            if (e == NONE) continue;
+            if (uf.find(cu[e]) != uf.find(cv[e])) {
+                uf.unite(cu[e], cv[e]);
+                mst.push_back(edges[eid[e]]);
+            }
+        }
+
+        // 3. Nouvelles étiquettes : une racine par ancienne étiquette.
+        size_t alive_labels = 0;
+        for (Vertex c : labels) {
+            const Vertex r = uf.find(c);
+            relabel[static_cast<size_t>(c)] = r;
+            if (r == c) labels[alive_labels++] = c;
+        }
+        labels.resize(alive_labels);
+
+        // 4. Contraction : arêtes réétiquetées, arêtes devenues internes retirées. Sur un thread, compaction
+        //    sur place ; sinon comptage par bloc, préfixe, puis recopie par bloc dans de nouveaux tableaux.
+        if (threads == 1) {
+            size_t j = 0;
+            for (size_t i = 0; i < m; ++i) {
+                const Vertex a = relabel[static_cast<size_t>(cu[i])];
+                const Vertex b = relabel[static_cast<size_t>(cv[i])];
+                if (a == b) continue;
+                cu[j] = a;
+                cv[j] = b;
+                ew[j] = ew[i];
+                eid[j] = eid[i];
+                ++j;
+            }
+            cu.resize(j);
+            cv.resize(j);
+            ew.resize(j);
+            eid.resize(j);
+            continue;
+        }
+        std::vector<size_t> kept(threads + 1, 0);
+        parallel_chunks(m, threads, [&](size_t b, size_t e, size_t t) {
+            size_t k = 0;
+            for (size_t i = b; i < e; ++i) {
+                cu[i] = relabel[static_cast<size_t>(cu[i])];
+                cv[i] = relabel[static_cast<size_t>(cv[i])];
+                if (cu[i] != cv[i]) ++k;
+            }
+            kept[t + 1] = k;
+        });
+        std::partial_sum(kept.begin(), kept.end(), kept.begin());
+        std::vector<Vertex> nu(kept.back()), nv(kept.back());
+        std::vector<Weight> nw(kept.back());
+        std::vector<EdgeId> nid(kept.back());
+        parallel_chunks(m, threads, [&](size_t b, size_t e, size_t t) {
+            size_t j = kept[t];
+            for (size_t i = b; i < e; ++i) {
+                if (cu[i] == cv[i]) continue;
+                nu[j] = cu[i];
+                nv[j] = cv[i];
+                nw[j] = ew[i];
+                nid[j] = eid[i];
+                ++j;
+            }
+        });
+        cu.swap(nu);
+        cv.swap(nv);
+        ew.swap(nw);
+        eid.swap(nid);
+    }
+    return Graph::from_edges(n, mst);
+}
+
+bool CompactGraph::has_integral_weights() const {
+    return std::all_of(weight_.begin(), weight_.end(), is_integral_weight<Weight>);
+}
+
+Graph CompactGraph::kruskal_radix() const {
+    assert(!directed_ && "Kruskal exige un graphe non orienté");
+    assert(has_integral_weights());
+    std::vector<PackedEdge> edges;
+    edges.reserve(static_cast<size_t>(num_edges()));
+    uint32_t max_w = 0;
+    for (Vertex u = 0; u < num_vertices(); ++u) {
+        for (EdgeIndex i = edge_begin(u); i < edge_end(u); ++i) {
+            const Vertex v = target(i);
+            if (v < u) continue;
+            const uint32_t w = static_cast<uint32_t>(weight(i));
+            max_w = std::max(max_w, w);
+            edges.push_back({w, u, v});
+        }
+    }
+    radix_sort_by_weight(edges, max_w);
+    const size_t alive = static_cast<size_t>(std::count(alive_.begin(), alive_.end(), 1));
+    const size_t forest_edges = alive > 0 ? alive - 1 : 0;
+    UnionFind uf(num_vertices());
+    std::vector<Edge> mst;
+    mst.reserve(forest_edges);
+    for (const PackedEdge& e : edges) {
+        if (mst.size() == forest_edges) break;
+        const Vertex ru = uf.find(e.u), rv = uf.find(e.v);
+        if (ru == rv) continue;
+        uf.unite(ru, rv);
+        mst.emplace_back(e.u, e.v, static_cast<Weight>(e.w));
+    }
+    return Graph::from_edges(num_vertices(), mst);
+}
+
+Graph CompactGraph::prim_radix(Vertex start) const {
+    assert(!directed_ && "Prim exige un graphe non orienté");
+    assert(is_alive(start));
+    assert(has_integral_weights());
+    uint32_t max_w = 0;
+    for (Weight w : weight_) max_w = std::max(max_w, static_cast<uint32_t>(w));
+    if (max_w >= MAX_BUCKET_WEIGHT) return prim(start);
+    const Vertex n = num_vertices();
+    BucketHeap heap(n, max_w);
+    std::vector<Vertex> from(static_cast<size_t>(n), -1);
+    std::vector<char> in_mst(static_cast<size_t>(n), 0);
+    std::vector<Edge> mst;
+    uint64_t pushes = 0, pops = 0;
+    // Chaque sommet hors arbre garde dans le tas sa meilleure arête vers l'arbre (clé = poids, from = extrémité).
+    for (Vertex u = start;;) {
+        in_mst[static_cast<size_t>(u)] = 1;
+        for (EdgeIndex i = edge_begin(u); i < edge_end(u); ++i) {
+            const Vertex v = target(i);
+            if (in_mst[static_cast<size_t>(v)]) continue;
+            const uint32_t k = static_cast<uint32_t>(weight(i));
+            if (heap.contains(v) && heap.key(v) <= k) continue;
+            heap.push(v, k);
+            from[static_cast<size_t>(v)] = u;
+            ++pushes;
+        }
+        if (heap.empty()) break;
+        const Vertex next = heap.pop_min();
+        ++pops;
+        mst.emplace_back(from[static_cast<size_t>(next)], next, static_cast<Weight>(heap.key(next)));
+        u = next;
+    }
+    STATS_ADD(HeapPushes, pushes);
+    STATS_ADD(HeapPops, pops);
+    return Graph::from_edges(n, mst);
+}
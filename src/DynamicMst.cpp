@@ -0,0 +1,197 @@
+#include "DynamicMst.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+DynamicMst::DynamicMst(Vertex n_vertices)
+    : n_(n_vertices) {
+    const Vertex count = n_vertices > 0 ? 2 * n_vertices - 1 : 0;
+    nodes_.resize(static_cast<size_t>(count));
+    for (Vertex i = 0; i < count; ++i) {
+        Node& x = nodes_[static_cast<size_t>(i)];
+        x.max_node = i;
+        x.value = x.max_value = std::numeric_limits<Weight>::lowest();
+    }
+    edge_u_.assign(static_cast<size_t>(count - std::max<Vertex>(n_vertices, 0)), -1);
+    edge_v_.assign(edge_u_.size(), -1);
+    // Pile : les plus petits indices sortent en premier.
+    for (Vertex e = count - 1; e >= n_vertices; --e) free_edges_.push_back(e);
+}
+
+DynamicMst DynamicMst::from_graph(const Graph& g) {
+    DynamicMst d(g.num_vertices());
+    for (const Edge& e : g.get_edges()) d.insert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+    return d;
+}
+
+void DynamicMst::pull(Vertex x) {
+    Node& nx = nodes_[static_cast<size_t>(x)];
+    nx.max_node = x;
+    nx.max_value = nx.value;
+    for (Vertex c : nx.child) {
+        if (c < 0) continue;
+        const Node& nc = nodes_[static_cast<size_t>(c)];
+        if (nc.max_value > nx.max_value) {
+            nx.max_value = nc.max_value;
+            nx.max_node = nc.max_node;
+        }
+    }
+}
+
+void DynamicMst::push(Vertex x) {
+    Node& nx = nodes_[static_cast<size_t>(x)];
+    if (!nx.flip) return;
+    for (Vertex c : nx.child) {
+        if (c < 0) continue;
+        Node& nc = nodes_[static_cast<size_t>(c)];
+        std::swap(nc.child[0], nc.child[1]);
+        nc.flip = !nc.flip;
+    }
+    nx.flip = false;
+}
+
+void DynamicMst::rotate(Vertex x) {
+    Node& nx = nodes_[static_cast<size_t>(x)];
+    const Vertex p = nx.parent;
+    Node& np = nodes_[static_cast<size_t>(p)];
+    const Vertex g = np.parent;
+    const int side = np.child[1] == x ? 1 : 0;
+    if (!is_splay_root(p)) {
+        Node& ng = nodes_[static_cast<size_t>(g)];
+        ng.child[ng.child[1] == p ? 1 : 0] = x;
+    }
+    nx.parent = g;
+    const Vertex b = nx.child[side ^ 1];
+    np.child[side] = b;
+    if (b >= 0) nodes_[static_cast<size_t>(b)].parent = p;
+    nx.child[side ^ 1] = p;
+    np.parent = x;
+    pull(p);
+    pull(x);
+}
+
+void DynamicMst::splay(Vertex x) {
+    // Inversions en attente propagées du haut vers le bas, sans récursion.
+    thread_local std::vector<Vertex> path;
+    path.clear();
+    for (Vertex y = x;; y = nodes_[static_cast<size_t>(y)].parent) {
+        path.push_back(y);
+        if (is_splay_root(y)) break;
+    }
+    for (size_t i = path.size(); i-- > 0;) push(path[i]);
+    while (!is_splay_root(x)) {
+        const Vertex p = nodes_[static_cast<size_t>(x)].parent;
+        if (!is_splay_root(p)) {
+            const Node& np = nodes_[static_cast<size_t>(p)];
+            const Node& ng = nodes_[static_cast<size_t>(np.parent)];
+            const bool zigzig = (ng.child[0] == p) == (np.child[0] == x);
+            rotate(zigzig ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+void DynamicMst::access(Vertex x) {
+    Vertex last = -1;
+    for (Vertex y = x; y >= 0; y = nodes_[static_cast<size_t>(y)].parent) {
+        splay(y);
+        nodes_[static_cast<size_t>(y)].child[1] = last;
+        pull(y);
+        last = y;
+    }
+    splay(x);
+}
+
+void DynamicMst::make_root(Vertex x) {
+    access(x);
+    Node& nx = nodes_[static_cast<size_t>(x)];
+    std::swap(nx.child[0], nx.child[1]);
+    nx.flip = !nx.flip;
+}
+
+Vertex DynamicMst::find_root(Vertex x) {
+    access(x);
+    Vertex r = x;
+    for (;;) {
+        push(r);
+        const Vertex l = nodes_[static_cast<size_t>(r)].child[0];
+        if (l < 0) break;
+        r = l;
+    }
+    splay(r);
+    return r;
+}
+
+void DynamicMst::link(Vertex x, Vertex y) {
+    make_root(x);
+    nodes_[static_cast<size_t>(x)].parent = y;
+}
+
+void DynamicMst::cut(Vertex x, Vertex y) {
+    make_root(x);
+    access(y);
+    // y racine splay, x son fils gauche direct (arête x–y).
+    nodes_[static_cast<size_t>(y)].child[0] = -1;
+    nodes_[static_cast<size_t>(x)].parent = -1;
+    pull(y);
+}
+
+Vertex DynamicMst::path_max_node(Vertex u, Vertex v) {
+    make_root(u);
+    // find_root(v) accède à v puis remonte la racine u en racine splay : l'arbre splay de u
+    // contient alors exactement le chemin u–v.
+    if (find_root(v) != u) return -1;
+    return nodes_[static_cast<size_t>(u)].max_node;
+}
+
+bool DynamicMst::connected(Vertex u, Vertex v) {
+    if (u < 0 || u >= n_ || v < 0 || v >= n_) return false;
+    return u == v || find_root(u) == find_root(v);
+}
+
+bool DynamicMst::insert_edge(Vertex u, Vertex v, Weight w) {
+    assert(0 <= u && u < n_ && 0 <= v && v < n_);
+    if (u == v) return false;
+    Vertex e = path_max_node(u, v);
+    if (e < 0) {
+        assert(!free_edges_.empty());
+        e = free_edges_.back();
+        free_edges_.pop_back();
+        ++edge_count_;
+    } else {
+        // Propriété de cycle : l'arête max du cycle formé sort si elle est plus lourde que w.
+        if (!(nodes_[static_cast<size_t>(e)].value > w)) return false;
+        const size_t k = static_cast<size_t>(e - n_);
+        cut(e, edge_u_[k]);
+        cut(e, edge_v_[k]);
+        total_weight_ -= nodes_[static_cast<size_t>(e)].value;
+    }
+    const size_t k = static_cast<size_t>(e - n_);
+    edge_u_[k] = u;
+    edge_v_[k] = v;
+    Node& ne = nodes_[static_cast<size_t>(e)];
+    ne.value = ne.max_value = w;
+    ne.max_node = e;
+    total_weight_ += w;
+    link(e, u);
+    link(e, v);
+    return true;
+}
+
+std::optional<Weight> DynamicMst::query(Vertex u, Vertex v) {
+    if (u < 0 || u >= n_ || v < 0 || v >= n_) return std::nullopt;
+    if (u == v) return 0;
+    const Vertex e = path_max_node(u, v);
+    if (e < 0) return std::nullopt;
+    return nodes_[static_cast<size_t>(e)].value;
+}
+
+std::vector<Edge> DynamicMst::edges() const {
+    std::vector<Edge> out;
+    out.reserve(edge_count_);
+    for (size_t k = 0; k < edge_u_.size(); ++k)
+        if (edge_u_[k] >= 0)
+            out.emplace_back(edge_u_[k], edge_v_[k], nodes_[static_cast<size_t>(n_) + k].value);
+    return out;
+}
@@ -0,0 +1,92 @@
+#include "FastInput.h"
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::optional<MappedFile> MappedFile::open(const std::string& path, bool sequential) {
+    MappedFile f;
+#if !defined(_WIN32)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return std::nullopt;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    f.size_ = static_cast<std::size_t>(st.st_size);
+    if (f.size_ > 0) {
+        void* p = ::mmap(nullptr, f.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        ::madvise(p, f.size_, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+        f.data_ = static_cast<const char*>(p);
+        f.mapped_ = true;
+    }
+    ::close(fd);
+#else
+    (void)sequential;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+    f.fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    f.data_ = f.fallback_.data();
+    f.size_ = f.fallback_.size();
+#endif
+    return f;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+    release();
+    mapped_ = other.mapped_;
+    size_ = other.size_;
+    fallback_ = std::move(other.fallback_);
+    data_ = mapped_ ? other.data_ : fallback_.data();
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapped_ = false;
+    return *this;
+}
+
+MappedFile::~MappedFile() { release(); }
+
+void MappedFile::release() {
+#if !defined(_WIN32)
+    if (mapped_ && data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+namespace {
+/** from_chars sur [p, end) ; p avance après le nombre. Hors bornes du type (poids entiers) : échec. */
+template <class T>
+bool parse_number(const char*& p, const char* end, T& x) {
+    auto [ptr, ec] = std::from_chars(p, end, x);
+    if (ec != std::errc() || ptr == p) return false;
+    p = ptr;
+    return true;
+}
+}  // namespace
+
+bool Scanner::next_weight(Weight& w) {
+    skip_blanks();
+    return p_ != end_ && parse_number(p_, end_, w);
+}
+
+bool Scanner::next_double(double& x) {
+    skip_blanks();
+    return p_ != end_ && parse_number(p_, end_, x);
+}
@@ -1,13 +1,20 @@
 #include "Graph.h"
+#include "CompactGraph.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <limits>
 #include <optional>
 #include <queue>
 #include <stack>
 #include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -17,7 +24,10 @@ void Graph::add_edge(Vertex u, Vertex v, Weight w) {
     cont[u].push_back({v, w});
     if (!directed) cont[v].push_back({u, w});
     center_valid_ = false;
+    krt_valid_ = false;
+    rmq_valid_ = false;
     max_path_table_.clear();
+    v3_answers_.clear();
 }
 
 void Graph::print_graph(std::ostream& out) const {
@@ -28,7 +38,7 @@ void Graph::print_graph(std::ostream& out) const {
         for (const auto& [v, w] : cont[u]) {
             if (!alive[v]) continue;
             if (!first) out << ", ";
-            out << "(" << v << ", " << w << ")";
+            out << "(" << v << ", " << +w << ")";  // +w : un poids uint8_t (rank8) s'affiche en nombre
             first = false;
         }
         out << '\n';
@@ -36,7 +46,7 @@ void Graph::print_graph(std::ostream& out) const {
 }
 
 void Graph::print_summary(std::ostream& out) const {
-    int n = 0;
+    Vertex n = 0;
     for (Vertex v = 0; v < num_vertices(); ++v)
         if (alive[v]) ++n;
     out << "sommets (vivants): " << n
@@ -55,7 +65,7 @@ void Graph::write_dot(std::ostream& out, const std::string& name) const {
         for (const auto& [v, w] : cont[u]) {
             if (!alive[v]) continue;
             if (directed || u <= v) {
-                out << "  " << u << edge_op << v << " [label=\"" << w << "\"];\n";
+                out << "  " << u << edge_op << v << " [label=\"" << +w << "\"];\n";
             }
         }
     }
@@ -72,10 +82,13 @@ void Graph::remove_vertex(Vertex v) {
     alive[v] = 0;
     free_vertices.push_back(v);
     center_valid_ = false;
+    krt_valid_ = false;
+    rmq_valid_ = false;
     max_path_table_.clear();
+    v3_answers_.clear();
 }
 
-int Graph::num_vertices() const { return static_cast<int>(cont.size()); }
+Vertex Graph::num_vertices() const { return static_cast<Vertex>(cont.size()); }
 
 bool Graph::is_alive(Vertex v) const {
     return v >= 0 && v < num_vertices() && alive[v] != 0;
@@ -99,8 +112,8 @@ std::vector<Edge> Graph::get_edges() const {
     return out;
 }
 
-int Graph::num_edges() const {
-    int n = 0;
+EdgeIndex Graph::num_edges() const {
+    EdgeIndex n = 0;
     for (Vertex u = 0; u < num_vertices(); ++u) {
         if (!alive[u]) continue;
         for (const auto& p : cont[u])
@@ -154,90 +167,92 @@ std::vector<Vertex> Graph::bfs(Vertex start) const {
     return order;
 }
 
-namespace {
-struct UnionFind {
-    std::vector<int> parent, rank;
-    explicit UnionFind(int n) : parent(n), rank(n, 0) {
-        for (int i = 0; i < n; ++i) parent[static_cast<size_t>(i)] = i;
-    }
-    int find(int x) {
-        if (parent[static_cast<size_t>(x)] != x)
-            parent[static_cast<size_t>(x)] = find(parent[static_cast<size_t>(x)]);
-        return parent[static_cast<size_t>(x)];
-    }
-    void unite(int x, int y) {
-        x = find(x), y = find(y);
-        if (x == y) return;
-        if (rank[static_cast<size_t>(x)] < rank[static_cast<size_t>(y)]) std::swap(x, y);
-        parent[static_cast<size_t>(y)] = x;
-        if (rank[static_cast<size_t>(x)] == rank[static_cast<size_t>(y)]) ++rank[static_cast<size_t>(x)];
+Graph Graph::from_edges(Vertex n_vertices, const std::vector<Edge>& edges, bool directed) {
+    std::vector<EdgeIndex> degree(static_cast<size_t>(n_vertices), 0);
+    for (const Edge& e : edges) {
+        ++degree[static_cast<size_t>(std::get<0>(e))];
+        if (!directed) ++degree[static_cast<size_t>(std::get<1>(e))];
     }
-};
-}  // namespace
-
-static Graph build_mst_graph(int n_vertices, const std::vector<Edge>& mst_edges) {
-    Graph mst;
-    for (int i = 0; i < n_vertices; ++i) mst.add_vertex();
-    for (const Edge& e : mst_edges) {
-        Vertex u = std::get<0>(e), v = std::get<1>(e);
-        Weight w = std::get<2>(e);
-        mst.add_edge(u, v, w);
+    std::vector<std::vector<std::pair<Vertex, Weight>>> adj(static_cast<size_t>(n_vertices));
+    for (Vertex i = 0; i < n_vertices; ++i) adj[static_cast<size_t>(i)].reserve(static_cast<size_t>(degree[static_cast<size_t>(i)]));
+    for (const Edge& e : edges) {
+        const Vertex u = std::get<0>(e), v = std::get<1>(e);
+        const Weight w = std::get<2>(e);
+        adj[static_cast<size_t>(u)].emplace_back(v, w);
+        if (!directed) adj[static_cast<size_t>(v)].emplace_back(u, w);
     }
-    return mst;
+    return Graph(std::move(adj), directed);
 }
 
+CompactGraph Graph::freeze() const { return CompactGraph(*this); }
+
 Graph Graph::kruskal() const {
     assert(!directed && "Kruskal exige un graphe non orienté");
-    std::vector<Edge> edges = get_edges();
-    std::sort(edges.begin(), edges.end(),
-              [](const Edge& a, const Edge& b) { return std::get<2>(a) < std::get<2>(b); });
-    UnionFind uf(num_vertices());
-    std::vector<Edge> mst;
-    for (const Edge& e : edges) {
-        Vertex u = std::get<0>(e), v = std::get<1>(e);
-        if (!is_alive(u) || !is_alive(v)) continue;
-        if (uf.find(u) != uf.find(v)) {
-            uf.unite(u, v);
-            mst.push_back(e);
-        }
-    }
-    return build_mst_graph(num_vertices(), mst);
+    return freeze().kruskal();
 }
 
 Graph Graph::prim(Vertex start) const {
     assert(!directed && "Prim exige un graphe non orienté");
     assert(0 <= start && start < num_vertices() && is_alive(start));
-    using E = std::tuple<Weight, Vertex, Vertex>;
-    std::priority_queue<E, std::vector<E>, std::greater<E>> pq;
-    std::vector<char> in_mst(static_cast<size_t>(num_vertices()), 0);
-    std::vector<Edge> mst;
-    in_mst[static_cast<size_t>(start)] = 1;
-    for (const auto& [v, w] : neighbors(start)) {
-        if (is_alive(v)) pq.emplace(w, start, v);
-    }
-    while (!pq.empty()) {
-        auto [w, from, to] = pq.top();
-        pq.pop();
-        if (in_mst[static_cast<size_t>(to)]) continue;
-        in_mst[static_cast<size_t>(to)] = 1;
-        mst.emplace_back(from, to, w);
-        for (const auto& [v, vw] : neighbors(to)) {
-            if (is_alive(v) && !in_mst[static_cast<size_t>(v)]) pq.emplace(vw, to, v);
-        }
-    }
-    return build_mst_graph(num_vertices(), mst);
+    return freeze().prim(start);
+}
+
+Graph Graph::kruskal_radix() const {
+    assert(!directed && "Kruskal exige un graphe non orienté");
+    return freeze().kruskal_radix();
+}
+
+Graph Graph::prim_radix(Vertex start) const {
+    assert(!directed && "Prim exige un graphe non orienté");
+    assert(0 <= start && start < num_vertices() && is_alive(start));
+    return freeze().prim_radix(start);
+}
+
+Graph Graph::boruvka(int n_threads) const {
+    assert(!directed && "Borůvka exige un graphe non orienté");
+    return freeze().boruvka(n_threads);
 }
 
 namespace {
+/** Cadre de la pile explicite de max_on_path_dfs : sommet, sommet d'où l'on vient, max courant, prochain voisin. */
+struct PathFrame {
+    Vertex vertex;
+    Vertex from;
+    Weight path_max;
+    size_t next;
+};
+
+/**
+ * DFS de current vers target en propageant le max des poids ; pile explicite (pas de récursion, donc pas de
+ * débordement sur les arbres très profonds), même ordre de visite que la version récursive.
+ * La pile est un tampon thread_local réutilisé d'une requête à l'autre.
+ */
 std::optional<Weight> max_on_path_dfs(const Graph& g, Vertex current, Vertex target,
                                       Vertex from, Weight path_max) {
-    if (current == target) return path_max;
-    for (const auto& [neighbor, w] : g.neighbors(current)) {
-        if (!g.is_alive(neighbor) || neighbor == from) continue;
-        Weight new_max = (path_max > w ? path_max : w);
-        auto res = max_on_path_dfs(g, neighbor, target, current, new_max);
-        if (res) return res;
+    thread_local std::vector<PathFrame> stack;
+    stack.clear();
+    stack.push_back({current, from, path_max, 0});
+    size_t visited = 1;
+    while (!stack.empty()) {
+        PathFrame& top = stack.back();
+        if (top.vertex == target) {
+            STATS_ADD(V1Visited, visited);
+            return top.path_max;
+        }
+        const auto& nb = g.neighbors(top.vertex);
+        bool descended = false;
+        while (top.next < nb.size()) {
+            const auto& [neighbor, w] = nb[top.next++];
+            if (!g.is_alive(neighbor) || neighbor == top.from) continue;
+            const Weight new_max = (top.path_max > w ? top.path_max : w);
+            stack.push_back({neighbor, top.vertex, new_max, 0});  // top invalide après push_back
+            ++visited;
+            descended = true;
+            break;
+        }
+        if (!descended) stack.pop_back();
     }
+    STATS_ADD(V1Visited, visited);
     return std::nullopt;
 }
 }  // namespace
@@ -250,28 +265,27 @@ std::optional<Weight> Graph::itineraries_v1(Vertex u, Vertex v) const {
 }
 
 namespace {
-std::pair<Vertex, std::vector<Vertex>> farthest_and_path(const Graph& g, Vertex start) {
-    const int n = g.num_vertices();
-    std::vector<int> dist(static_cast<size_t>(n), -1);
+std::pair<Vertex, std::vector<Vertex>> farthest_and_path(const CompactGraph& g, Vertex start) {
+    const Vertex n = g.num_vertices();
+    std::vector<Vertex> dist(static_cast<size_t>(n), -1);
     std::vector<Vertex> parent_bfs(static_cast<size_t>(n), -1);
-    std::queue<Vertex> q;
-    q.push(start);
+    std::vector<Vertex> queue;
+    queue.reserve(static_cast<size_t>(n));
+    queue.push_back(start);
     dist[static_cast<size_t>(start)] = 0;
-    while (!q.empty()) {
-        Vertex u = q.front();
-        q.pop();
-        for (const auto& [v, w] : g.neighbors(u)) {
-            (void)w;
-            if (!g.is_alive(v) || dist[static_cast<size_t>(v)] >= 0) continue;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Vertex u = queue[head];
+        for (EdgeIndex i = g.edge_begin(u); i < g.edge_end(u); ++i) {
+            const Vertex v = g.target(i);
+            if (dist[static_cast<size_t>(v)] >= 0) continue;
             dist[static_cast<size_t>(v)] = dist[static_cast<size_t>(u)] + 1;
             parent_bfs[static_cast<size_t>(v)] = u;
-            q.push(v);
+            queue.push_back(v);
         }
     }
     Vertex farthest = start;
     for (Vertex v = 0; v < n; ++v)
-        if (g.is_alive(v) && dist[static_cast<size_t>(v)] >= 0 &&
-            dist[static_cast<size_t>(v)] > dist[static_cast<size_t>(farthest)])
+        if (dist[static_cast<size_t>(v)] > dist[static_cast<size_t>(farthest)])
             farthest = v;
     std::vector<Vertex> path;
     for (Vertex v = farthest; v != -1; v = parent_bfs[static_cast<size_t>(v)])
@@ -280,40 +294,62 @@ std::pair<Vertex, std::vector<Vertex>> farthest_and_path(const Graph& g, Vertex
     return {farthest, path};
 }
 
-void dfs_fill_parent(const Graph& g, Vertex current, Vertex from,
+/** Parent et poids de l'arête vers le parent pour tout l'arbre enraciné en root ; pile explicite. */
+void dfs_fill_parent(const CompactGraph& g, Vertex root,
                      std::vector<Vertex>& parent,
                      std::vector<Weight>& parent_edge_weight) {
-    for (const auto& [v, w] : g.neighbors(current)) {
-        if (!g.is_alive(v) || v == from) continue;
-        parent[static_cast<size_t>(v)] = current;
-        parent_edge_weight[static_cast<size_t>(v)] = w;
-        dfs_fill_parent(g, v, current, parent, parent_edge_weight);
+    std::vector<Vertex> stack;
+    stack.reserve(static_cast<size_t>(g.num_vertices()));
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Vertex current = stack.back();
+        stack.pop_back();
+        const Vertex from = parent[static_cast<size_t>(current)];
+        for (EdgeIndex i = g.edge_begin(current); i < g.edge_end(current); ++i) {
+            const Vertex v = g.target(i);
+            if (v == from) continue;
+            parent[static_cast<size_t>(v)] = current;
+            parent_edge_weight[static_cast<size_t>(v)] = g.weight(i);
+            stack.push_back(v);
+        }
     }
 }
 }  // namespace
 
-void Graph::compute_center_and_parent() {
+TreeLayout default_tree_layout() {
+    static const TreeLayout layout = [] {
+        const char* env = std::getenv("LAYOUT");
+        if (env && std::strcmp(env, "input") == 0) return TreeLayout::Input;
+        if (env && std::strcmp(env, "preorder") == 0) return TreeLayout::Preorder;
+        return TreeLayout::Auto;
+    }();
+    return layout;
+}
+
+void Graph::compute_center_and_parent(TreeLayout layout) {
     assert(!directed && "Centre/parent pour graphe non orienté (arbre)");
-    const int n = num_vertices();
+    const Vertex n = num_vertices();
     Vertex start = -1;
     for (Vertex v = 0; v < n; ++v)
         if (is_alive(v)) { start = v; break; }
     if (start == -1) {
         center_valid_ = false;
         max_path_table_.clear();
+        v3_answers_.clear();
         return;
     }
-    auto [u, path1] = farthest_and_path(*this, start);
-    auto [v, path_diam] = farthest_and_path(*this, u);
-    const int L = static_cast<int>(path_diam.size()) - 1;
+    const CompactGraph csr = freeze();
+    auto [u, path1] = farthest_and_path(csr, start);
+    auto [v, path_diam] = farthest_and_path(csr, u);
+    const Vertex L = static_cast<Vertex>(path_diam.size()) - 1;
     if (L <= 0) {
         centre_ = path_diam.empty() ? start : path_diam[0];
         diameter_length_ = L;
         parent_.assign(static_cast<size_t>(n), -1);
         parent_[static_cast<size_t>(centre_)] = -1;
         parent_edge_weight_.resize(static_cast<size_t>(n), 0);
-        dfs_fill_parent(*this, centre_, -1, parent_, parent_edge_weight_);
-        build_binary_lifting(n);
+        dfs_fill_parent(csr, centre_, parent_, parent_edge_weight_);
+        build_binary_lifting(csr, layout);
         center_valid_ = true;
         return;
     }
@@ -326,51 +362,94 @@ void Graph::compute_center_and_parent() {
     parent_.resize(static_cast<size_t>(n), -1);
     parent_[static_cast<size_t>(centre_)] = -1;
     parent_edge_weight_.resize(static_cast<size_t>(n), 0);
-    dfs_fill_parent(*this, centre_, -1, parent_, parent_edge_weight_);
-    build_binary_lifting(n);
+    dfs_fill_parent(csr, centre_, parent_, parent_edge_weight_);
+    build_binary_lifting(csr, layout);
     center_valid_ = true;
 }
 
-void Graph::build_binary_lifting(int n) {
-    depth_.assign(static_cast<size_t>(n), -1);
-    depth_[static_cast<size_t>(centre_)] = 0;
-    std::queue<Vertex> q;
-    q.push(centre_);
-    while (!q.empty()) {
-        Vertex u = q.front();
-        q.pop();
-        for (const auto& [v, w] : neighbors(u)) {
-            (void)w;
-            if (!is_alive(v) || parent_[static_cast<size_t>(v)] != u) continue;
-            depth_[static_cast<size_t>(v)] = depth_[static_cast<size_t>(u)] + 1;
-            q.push(v);
+void Graph::build_binary_lifting(const CompactGraph& g, TreeLayout layout) {
+    const Vertex n = g.num_vertices();
+    const size_t un = static_cast<size_t>(n);
+    std::vector<Vertex> depth(un, -1);
+    depth[static_cast<size_t>(centre_)] = 0;
+    std::vector<Vertex> queue;
+    queue.reserve(un);
+    queue.push_back(centre_);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Vertex u = queue[head];
+        for (EdgeIndex i = g.edge_begin(u); i < g.edge_end(u); ++i) {
+            const Vertex v = g.target(i);
+            if (parent_[static_cast<size_t>(v)] != u) continue;
+            depth[static_cast<size_t>(v)] = depth[static_cast<size_t>(u)] + 1;
+            queue.push_back(v);
         }
     }
-    int max_k = 0;
-    while ((1 << max_k) < n) ++max_k;
-    up_.assign(static_cast<size_t>(n), std::vector<Vertex>(static_cast<size_t>(max_k + 1), -1));
-    max_up_.assign(static_cast<size_t>(n), std::vector<Weight>(static_cast<size_t>(max_k + 1), std::numeric_limits<Weight>::lowest()));
-    for (Vertex v = 0; v < n; ++v) {
-        if (!is_alive(v) || depth_[static_cast<size_t>(v)] < 0) continue;
-        up_[static_cast<size_t>(v)][0] = parent_[static_cast<size_t>(v)];
-        if (parent_[static_cast<size_t>(v)] >= 0)
-            max_up_[static_cast<size_t>(v)][0] = parent_edge_weight_[static_cast<size_t>(v)];
-    }
-    for (int k = 1; k <= max_k; ++k) {
-        for (Vertex v = 0; v < n; ++v) {
-            if (!is_alive(v) || depth_[static_cast<size_t>(v)] < 0) continue;
-            Vertex mid = up_[static_cast<size_t>(v)][static_cast<size_t>(k - 1)];
-            if (mid < 0) {
-                up_[static_cast<size_t>(v)][static_cast<size_t>(k)] = -1;
-                continue;
+
+    Vertex max_depth = 0;
+    for (Vertex d : depth) max_depth = std::max(max_depth, d);
+    int levels = 1;
+    while ((Vertex{1} << levels) <= max_depth) ++levels;
+    if (layout == TreeLayout::Auto) layout = levels >= LiftingView::DEEP_LEVELS ? TreeLayout::Preorder : TreeLayout::Input;
+
+    // order[x] = sommet de numéro interne x ; les sommets hors de l'arbre (morts, autre composante) à la fin.
+    std::vector<Vertex> order;
+    order.reserve(un);
+    if (layout == TreeLayout::Preorder) {
+        // Tailles des sous-arbres (BFS à rebours), puis DFS itératif : l'enfant le plus lourd est empilé en
+        // dernier, donc numéroté juste après son parent.
+        std::vector<Vertex> size(un, 1);
+        for (size_t i = queue.size(); i-- > 1;)
+            size[static_cast<size_t>(parent_[static_cast<size_t>(queue[i])])] += size[static_cast<size_t>(queue[i])];
+        std::vector<Vertex> stack{centre_};
+        while (!stack.empty()) {
+            const Vertex u = stack.back();
+            stack.pop_back();
+            order.push_back(u);
+            Vertex heavy = -1;
+            for (EdgeIndex i = g.edge_begin(u); i < g.edge_end(u); ++i) {
+                Vertex v = g.target(i);
+                if (parent_[static_cast<size_t>(v)] != u) continue;
+                if (heavy < 0 || size[static_cast<size_t>(v)] > size[static_cast<size_t>(heavy)]) std::swap(heavy, v);
+                if (v >= 0) stack.push_back(v);
             }
-            up_[static_cast<size_t>(v)][static_cast<size_t>(k)] = up_[static_cast<size_t>(mid)][static_cast<size_t>(k - 1)];
-            Weight w1 = max_up_[static_cast<size_t>(v)][static_cast<size_t>(k - 1)];
-            Weight w2 = up_[static_cast<size_t>(mid)][static_cast<size_t>(k - 1)] >= 0
-                ? max_up_[static_cast<size_t>(mid)][static_cast<size_t>(k - 1)]
-                : std::numeric_limits<Weight>::lowest();
-            max_up_[static_cast<size_t>(v)][static_cast<size_t>(k)] = (w1 > w2 ? w1 : w2);
+            if (heavy >= 0) stack.push_back(heavy);
         }
+        for (Vertex v = 0; v < n; ++v)
+            if (depth[static_cast<size_t>(v)] < 0) order.push_back(v);
+        label_.assign(un, -1);
+        for (size_t x = 0; x < un; ++x) label_[static_cast<size_t>(order[x])] = static_cast<Vertex>(x);
+    } else {
+        for (Vertex v = 0; v < n; ++v) order.push_back(v);
+        label_.clear();
+    }
+
+    depth_.resize(un);
+    for (size_t x = 0; x < un; ++x) depth_[x] = depth[static_cast<size_t>(order[x])];
+    lift_levels_ = levels;
+    lift_stride_ = un;
+    lift_.assign(static_cast<size_t>(levels) * lift_stride_, LiftEntry{std::numeric_limits<Weight>::lowest(), -1});
+    for (size_t x = 0; x < un; ++x) {
+        const Vertex v = order[x];
+        const Vertex p = parent_[static_cast<size_t>(v)];
+        if (depth_[x] < 0 || p < 0) continue;
+        lift_[x].up = internal(p);
+        lift_[x].max = parent_edge_weight_[static_cast<size_t>(v)];
+    }
+    // Niveau k calculé séquentiellement à partir du niveau k-1 (tables contiguës par niveau).
+    for (int k = 1; k < levels; ++k) {
+        const LiftEntry* prev = lift_.data() + static_cast<size_t>(k - 1) * lift_stride_;
+        LiftEntry* cur = lift_.data() + static_cast<size_t>(k) * lift_stride_;
+        for (Vertex x = 0; x < n; ++x) {
+            const Vertex mid = prev[x].up;
+            if (mid < 0) continue;
+            cur[x].up = prev[mid].up;
+            cur[x].max = prev[x].max > prev[mid].max ? prev[x].max : prev[mid].max;
+        }
+    }
+    if (layout == TreeLayout::Preorder) {
+        order_ = std::move(order);
+    } else {
+        order_.clear();
     }
 }
 
@@ -381,7 +460,7 @@ Vertex Graph::get_center() const {
     return centre_;
 }
 
-int Graph::get_diameter_length() const {
+Vertex Graph::get_diameter_length() const {
     assert(center_valid_ && "Appeler compute_center_and_parent() d'abord");
     return diameter_length_;
 }
@@ -395,152 +474,523 @@ Vertex Graph::get_parent(Vertex v) const {
 std::optional<Vertex> Graph::lca(Vertex u, Vertex v) const {
     if (!center_valid_) return std::nullopt;
     if (!is_alive(u) || !is_alive(v)) return std::nullopt;
-    if (up_.empty()) return std::nullopt;
-    const int du = depth_[static_cast<size_t>(u)];
-    const int dv = depth_[static_cast<size_t>(v)];
+    if (lift_.empty()) return std::nullopt;
+    u = internal(u);
+    v = internal(v);
+    const Vertex du = depth_[static_cast<size_t>(u)];
+    const Vertex dv = depth_[static_cast<size_t>(v)];
     if (du < 0 || dv < 0) return std::nullopt;
     if (du < dv) std::swap(u, v);
-    int d = depth_[static_cast<size_t>(u)] - depth_[static_cast<size_t>(v)];
-    const int max_k = static_cast<int>(up_[static_cast<size_t>(u)].size()) - 1;
-    for (int k = max_k; k >= 0 && d > 0; --k)
-        if (d >= (1 << k)) {
-            u = up_[static_cast<size_t>(u)][static_cast<size_t>(k)];
-            d -= (1 << k);
+    Vertex d = depth_[static_cast<size_t>(u)] - depth_[static_cast<size_t>(v)];
+    for (int k = lift_levels_ - 1; k >= 0 && d > 0; --k)
+        if (d >= (Vertex{1} << k)) {
+            u = lift(k, u).up;
+            d -= (Vertex{1} << k);
         }
-    if (u == v) return u;
-    for (int k = max_k; k >= 0; --k) {
-        if (up_[static_cast<size_t>(u)][static_cast<size_t>(k)] != up_[static_cast<size_t>(v)][static_cast<size_t>(k)]) {
-            u = up_[static_cast<size_t>(u)][static_cast<size_t>(k)];
-            v = up_[static_cast<size_t>(v)][static_cast<size_t>(k)];
+    if (u == v) return external(u);
+    for (int k = lift_levels_ - 1; k >= 0; --k) {
+        const Vertex au = lift(k, u).up, av = lift(k, v).up;
+        if (au != av) {
+            u = au;
+            v = av;
         }
     }
-    return up_[static_cast<size_t>(u)][0];
+    const Vertex a = lift(0, u).up;
+    return a >= 0 ? external(a) : a;
 }
 
 std::vector<std::optional<Vertex>> Graph::tarjan_lca(const std::vector<std::pair<Vertex, Vertex>>& queries) const {
     std::vector<std::optional<Vertex>> result(queries.size(), std::nullopt);
     if (!center_valid_) return result;
-    const int n = num_vertices();
-    std::vector<std::vector<Vertex>> children(static_cast<size_t>(n));
+    const Vertex n = num_vertices();
+    const size_t un = static_cast<size_t>(n);
+
+    // Enfants et requêtes par sommet en CSR (comptage, préfixe, remplissage) : pas de vecteur par sommet.
+    std::vector<Vertex> child_offset(un + 1, 0);
     for (Vertex v = 0; v < n; ++v) {
         if (!is_alive(v)) continue;
-        Vertex p = parent_[static_cast<size_t>(v)];
-        if (p >= 0) children[static_cast<size_t>(p)].push_back(v);
+        const Vertex p = parent_[static_cast<size_t>(v)];
+        if (p >= 0) ++child_offset[static_cast<size_t>(p) + 1];
+    }
+    for (size_t i = 0; i < un; ++i) child_offset[i + 1] += child_offset[i];
+    std::vector<Vertex> children(static_cast<size_t>(child_offset[un]));
+    {
+        std::vector<Vertex> fill(child_offset.begin(), child_offset.end() - 1);
+        for (Vertex v = 0; v < n; ++v) {
+            if (!is_alive(v)) continue;
+            const Vertex p = parent_[static_cast<size_t>(v)];
+            if (p >= 0) children[static_cast<size_t>(fill[static_cast<size_t>(p)]++)] = v;
+        }
     }
-    std::vector<std::vector<std::pair<Vertex, size_t>>> q_by_node(static_cast<size_t>(n));
-    for (size_t i = 0; i < queries.size(); ++i) {
-        Vertex a = queries[i].first, b = queries[i].second;
+    std::vector<size_t> q_offset(un + 1, 0);
+    for (const auto& [a, b] : queries) {
         if (!is_alive(a) || !is_alive(b)) continue;
-        q_by_node[static_cast<size_t>(a)].emplace_back(b, i);
-        if (a != b) q_by_node[static_cast<size_t>(b)].emplace_back(a, i);
+        ++q_offset[static_cast<size_t>(a) + 1];
+        if (a != b) ++q_offset[static_cast<size_t>(b) + 1];
+    }
+    for (size_t i = 0; i < un; ++i) q_offset[i + 1] += q_offset[i];
+    std::vector<std::pair<Vertex, size_t>> q_by_node(q_offset[un]);
+    {
+        std::vector<size_t> fill(q_offset.begin(), q_offset.end() - 1);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const Vertex a = queries[i].first, b = queries[i].second;
+            if (!is_alive(a) || !is_alive(b)) continue;
+            q_by_node[fill[static_cast<size_t>(a)]++] = {b, i};
+            if (a != b) q_by_node[fill[static_cast<size_t>(b)]++] = {a, i};
+        }
     }
-    std::vector<Vertex> parent_uf(static_cast<size_t>(n), -1);
-    std::vector<Vertex> set_ancestor(static_cast<size_t>(n), -1);
-    std::vector<char> visited(static_cast<size_t>(n), 0);
 
-    std::function<Vertex(Vertex)> Find = [&](Vertex x) {
-        if (parent_uf[static_cast<size_t>(x)] != x)
-            parent_uf[static_cast<size_t>(x)] = Find(parent_uf[static_cast<size_t>(x)]);
-        return parent_uf[static_cast<size_t>(x)];
-    };
-    auto Union = [&](Vertex u, Vertex v) {
-        Vertex ru = Find(u), rv = Find(v);
-        if (ru == rv) return;
-        parent_uf[static_cast<size_t>(rv)] = ru;
-        set_ancestor[static_cast<size_t>(ru)] = u;
+    std::vector<Vertex> parent_uf(un, -1);
+    std::vector<Vertex> set_ancestor(un, -1);
+    std::vector<char> visited(un, 0);
+    // Compteurs locaux, publiés une fois en fin d'appel.
+    uint64_t finds = 0, compressions = 0;
+    auto find = [&](Vertex x) {
+        // Compression par moitié, itérative.
+        ++finds;
+        while (parent_uf[static_cast<size_t>(x)] != x) {
+            Vertex& px = parent_uf[static_cast<size_t>(x)];
+            px = parent_uf[static_cast<size_t>(px)];
+            x = px;
+            ++compressions;
+        }
+        return x;
     };
 
-    std::function<void(Vertex)> TarjanLCA = [&](Vertex u) {
-        parent_uf[static_cast<size_t>(u)] = u;
-        set_ancestor[static_cast<size_t>(u)] = u;
-        for (Vertex v : children[static_cast<size_t>(u)]) {
-            TarjanLCA(v);
-            Union(u, v);
-            set_ancestor[static_cast<size_t>(Find(u))] = u;
+    // DFS itératif : (sommet, prochain enfant). Au retour d'un enfant v vers u : union puis ancêtre = u.
+    std::vector<std::pair<Vertex, Vertex>> stack;
+    stack.reserve(un);
+    parent_uf[static_cast<size_t>(centre_)] = centre_;
+    set_ancestor[static_cast<size_t>(centre_)] = centre_;
+    stack.emplace_back(centre_, child_offset[static_cast<size_t>(centre_)]);
+    while (!stack.empty()) {
+        auto& [u, next] = stack.back();
+        if (next < child_offset[static_cast<size_t>(u) + 1]) {
+            const Vertex v = children[static_cast<size_t>(next++)];
+            parent_uf[static_cast<size_t>(v)] = v;
+            set_ancestor[static_cast<size_t>(v)] = v;
+            stack.emplace_back(v, child_offset[static_cast<size_t>(v)]);
+            continue;
         }
-        visited[static_cast<size_t>(u)] = 1;
-        for (const auto& [v, idx] : q_by_node[static_cast<size_t>(u)]) {
-            if (visited[static_cast<size_t>(v)])
-                result[idx] = set_ancestor[static_cast<size_t>(Find(v))];
+        const Vertex done = u;
+        visited[static_cast<size_t>(done)] = 1;
+        for (size_t i = q_offset[static_cast<size_t>(done)]; i < q_offset[static_cast<size_t>(done) + 1]; ++i) {
+            const auto& [v, idx] = q_by_node[i];
+            if (visited[static_cast<size_t>(v)]) result[idx] = set_ancestor[static_cast<size_t>(find(v))];
         }
-    };
-
-    TarjanLCA(centre_);
+        stack.pop_back();
+        if (stack.empty()) break;
+        const Vertex p = stack.back().first;
+        const Vertex rp = find(p), rd = find(done);
+        if (rp != rd) parent_uf[static_cast<size_t>(rd)] = rp;
+        set_ancestor[static_cast<size_t>(rp)] = p;
+    }
+    STATS_ADD(UfFinds, finds);
+    STATS_ADD(UfCompressions, compressions);
     return result;
 }
 
 std::optional<Weight> Graph::max_on_path_to_ancestor(Vertex u, Vertex a) const {
     if (!center_valid_ || !is_alive(u) || !is_alive(a)) return std::nullopt;
     if (u == a) return 0;
-    const int du = depth_[static_cast<size_t>(u)];
-    const int da = depth_[static_cast<size_t>(a)];
-    int d = du - da;
+    u = internal(u);
+    a = internal(a);
+    const Vertex du = depth_[static_cast<size_t>(u)];
+    const Vertex da = depth_[static_cast<size_t>(a)];
+    Vertex d = du - da;
     if (d <= 0) return std::nullopt;
-    const int max_k = static_cast<int>(up_[static_cast<size_t>(u)].size()) - 1;
     Weight result = std::numeric_limits<Weight>::lowest();
     Vertex current = u;
-    for (int k = max_k; k >= 0 && d > 0; --k) {
-        if (d >= (1 << k)) {
-            Weight w = max_up_[static_cast<size_t>(current)][static_cast<size_t>(k)];
-            if (w > result) result = w;
-            current = up_[static_cast<size_t>(current)][static_cast<size_t>(k)];
-            d -= (1 << k);
+    for (int k = lift_levels_ - 1; k >= 0 && d > 0; --k) {
+        if (d >= (Vertex{1} << k)) {
+            const LiftEntry& e = lift(k, current);
+            if (e.max > result) result = e.max;
+            current = e.up;
+            d -= (Vertex{1} << k);
         }
     }
     if (current != a) return std::nullopt;
     return result;
 }
 
+std::optional<Weight> LiftingView::bottleneck(Vertex u, Vertex v) const {
+    u = internal(u);
+    v = internal(v);
+    Vertex du = depth[u];
+    Vertex dv = depth[v];
+    if (du < 0 || dv < 0) return std::nullopt;
+    if (du < dv) {
+        std::swap(u, v);
+        std::swap(du, dv);
+    }
+    // LCA et max en une seule passe : chaque saut lit l'ancêtre et le max dans la même case.
+    Weight result = std::numeric_limits<Weight>::lowest();
+    Vertex d = du - dv;
+    STATS_ADD(LiftJumps, __builtin_popcountll(static_cast<unsigned long long>(d)));
+    for (int k = levels - 1; k >= 0 && d > 0; --k) {
+        if (d >= (Vertex{1} << k)) {
+            const LiftEntry& e = at(k, u);
+            if (e.max > result) result = e.max;
+            u = e.up;
+            d -= (Vertex{1} << k);
+        }
+    }
+    // v ancêtre de u : max_on_path_to_ancestor(v, v) vaut 0.
+    if (u == v) return result > 0 ? result : 0;
+    STATS_ADD(LiftJumps, 2 * levels + 2);
+    for (int k = levels - 1; k >= 0; --k) {
+        const LiftEntry& eu = at(k, u);
+        const LiftEntry& ev = at(k, v);
+        if (eu.up != ev.up) {
+            if (eu.max > result) result = eu.max;
+            if (ev.max > result) result = ev.max;
+            u = eu.up;
+            v = ev.up;
+        }
+    }
+    const LiftEntry& eu = at(0, u);
+    const LiftEntry& ev = at(0, v);
+    if (eu.up < 0) return std::nullopt;  // pas d'ancêtre commun
+    if (eu.max > result) result = eu.max;
+    if (ev.max > result) result = ev.max;
+    return result;
+}
+
 std::optional<Weight> Graph::itineraries_v2(Vertex u, Vertex v) const {
     if (!center_valid_ || !is_alive(u) || !is_alive(v)) return std::nullopt;
-    auto L = lca(u, v);
-    if (!L) return std::nullopt;
-    auto mu = max_on_path_to_ancestor(u, *L);
-    auto mv = max_on_path_to_ancestor(v, *L);
-    if (!mu || !mv) return std::nullopt;
-    return (*mu > *mv) ? *mu : *mv;
+    if (lift_.empty()) return std::nullopt;
+    return lifting_view().bottleneck(u, v);
+}
+
+std::vector<std::optional<Weight>> Graph::answer_batch(const std::vector<std::pair<Vertex, Vertex>>& queries,
+                                                      int n_threads, BatchOrder order, size_t min_per_thread) const {
+    std::vector<std::optional<Weight>> result(queries.size());
+    if (n_threads <= 0) n_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const size_t max_threads = std::max<size_t>(1, queries.size() / std::max<size_t>(1, min_per_thread));
+    const size_t threads = std::min(static_cast<size_t>(n_threads), max_threads);
+    if (!center_valid_ || lift_.empty()) return result;
+    const LiftingView view = lifting_view();
+    // Bornes multiples de 8 cases : deux threads n'écrivent jamais dans la même ligne de cache.
+    const size_t chunk = ((queries.size() + threads - 1) / threads + 7) / 8 * 8;
+    parallel_chunks(queries.size(), threads, [&](size_t begin, size_t end, size_t) {
+        view.bottleneck_batch(alive.data(), queries.data() + begin, end - begin, result.data() + begin, order);
+    }, chunk);
+    return result;
 }
 
 void Graph::preprocess_itineraries_v3(const std::vector<std::pair<Vertex, Vertex>>& queries) {
     max_path_table_.clear();
-    if (!center_valid_) return;
-    auto lca_results = tarjan_lca(queries);
-    for (size_t i = 0; i < queries.size(); ++i) {
-        Vertex u = queries[i].first, v = queries[i].second;
-        if (!is_alive(u) || !is_alive(v)) continue;
-        auto L = lca_results[i];
-        if (!L) continue;
-        auto mu = max_on_path_to_ancestor(u, *L);
-        auto mv = max_on_path_to_ancestor(v, *L);
-        Weight w = 0;
-        if (mu && mv) w = (*mu > *mv) ? *mu : *mv;
-        else if (mu) w = *mu;
-        else if (mv) w = *mv;
-        Vertex a = (u < v) ? u : v;
-        Vertex b = (u < v) ? v : u;
-        max_path_table_[{a, b}] = w;
+    v3_answers_.clear();
+    const Vertex n = num_vertices();
+    const size_t un = static_cast<size_t>(n);
+    const CompactGraph csr = freeze();
+
+    // Requêtes par sommet en CSR ; u == v se répond sans parcours.
+    std::vector<std::optional<Weight>> answers(queries.size());
+    std::vector<size_t> q_offset(un + 1, 0);
+    for (const auto& [a, b] : queries) {
+        if (a == b || !is_alive(a) || !is_alive(b)) continue;
+        ++q_offset[static_cast<size_t>(a) + 1];
+        ++q_offset[static_cast<size_t>(b) + 1];
     }
+    for (size_t i = 0; i < un; ++i) q_offset[i + 1] += q_offset[i];
+    std::vector<std::pair<Vertex, size_t>> q_by_node(q_offset[un]);
+    {
+        std::vector<size_t> fill(q_offset.begin(), q_offset.end() - 1);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const Vertex a = queries[i].first, b = queries[i].second;
+            if (!is_alive(a) || !is_alive(b)) continue;
+            if (a == b) {
+                answers[i] = 0;
+                continue;
+            }
+            q_by_node[fill[static_cast<size_t>(a)]++] = {b, i};
+            q_by_node[fill[static_cast<size_t>(b)]++] = {a, i};
+        }
+    }
+
+    // Union-find pondéré : uf[x] est un ancêtre de x (le représentant est toujours le sommet de la pile
+    // qui a absorbé l'ensemble, donc pas d'union par rang), up_max[x] le max sur le chemin x → uf[x].
+    std::vector<Vertex> uf(un, -1);
+    std::vector<Weight> up_max(un, std::numeric_limits<Weight>::lowest());
+    std::vector<Vertex> tree_of(un, -1);
+    std::vector<char> done(un, 0);
+    std::vector<Vertex> path;
+    uint64_t finds = 0, compressions = 0;
+    auto find = [&](Vertex x) {
+        ++finds;
+        while (uf[static_cast<size_t>(x)] != x) {
+            path.push_back(x);
+            x = uf[static_cast<size_t>(x)];
+        }
+        compressions += path.size();
+        // Compression du haut vers le bas : le parent de chaque sommet pointe déjà sur la racine.
+        for (size_t i = path.size(); i-- > 0;) {
+            const Vertex y = path[i];
+            const Vertex py = uf[static_cast<size_t>(y)];
+            if (py != x && up_max[static_cast<size_t>(py)] > up_max[static_cast<size_t>(y)])
+                up_max[static_cast<size_t>(y)] = up_max[static_cast<size_t>(py)];
+            uf[static_cast<size_t>(y)] = x;
+        }
+        path.clear();
+        return x;
+    };
+    // Requêtes en attente sur leur LCA : listes chaînées dans deux tableaux, répondues à la fin du LCA.
+    std::vector<long long> lca_head(un, -1);
+    std::vector<long long> lca_next(queries.size(), -1);
+
+    struct Frame {
+        Vertex vertex;
+        Vertex from;
+        EdgeIndex next;
+        Weight edge_to_from;
+    };
+    std::vector<Frame> stack;
+    stack.reserve(un);
+    for (Vertex root = 0; root < n; ++root) {
+        if (!csr.is_alive(root) || tree_of[static_cast<size_t>(root)] >= 0) continue;
+        uf[static_cast<size_t>(root)] = root;
+        tree_of[static_cast<size_t>(root)] = root;
+        stack.push_back({root, -1, csr.edge_begin(root), 0});
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            if (f.next < csr.edge_end(f.vertex)) {
+                const EdgeIndex i = f.next++;
+                const Vertex t = csr.target(i);
+                if (t == f.from) continue;
+                uf[static_cast<size_t>(t)] = t;
+                tree_of[static_cast<size_t>(t)] = root;
+                stack.push_back({t, f.vertex, csr.edge_begin(t), csr.weight(i)});  // f invalide ensuite
+                continue;
+            }
+            // Fin de u : tous ses enfants sont fusionnés dans son ensemble.
+            const Vertex u = f.vertex;
+            const Weight edge_to_parent = f.edge_to_from;
+            stack.pop_back();
+            done[static_cast<size_t>(u)] = 1;
+            for (size_t k = q_offset[static_cast<size_t>(u)]; k < q_offset[static_cast<size_t>(u) + 1]; ++k) {
+                const auto& [other, idx] = q_by_node[k];
+                if (!done[static_cast<size_t>(other)] || tree_of[static_cast<size_t>(other)] != root) continue;
+                const Vertex lca = find(other);
+                lca_next[idx] = lca_head[static_cast<size_t>(lca)];
+                lca_head[static_cast<size_t>(lca)] = static_cast<long long>(idx);
+            }
+            for (long long q = lca_head[static_cast<size_t>(u)]; q >= 0; q = lca_next[static_cast<size_t>(q)]) {
+                const Vertex a = queries[static_cast<size_t>(q)].first;
+                const Vertex b = queries[static_cast<size_t>(q)].second;
+                // Chemin non vide (a != b) : l'extrémité égale au LCA ne contribue aucune arête.
+                Weight wa = std::numeric_limits<Weight>::lowest(), wb = wa;
+                if (a != u) {
+                    find(a);
+                    wa = up_max[static_cast<size_t>(a)];
+                }
+                if (b != u) {
+                    find(b);
+                    wb = up_max[static_cast<size_t>(b)];
+                }
+                answers[static_cast<size_t>(q)] = wa > wb ? wa : wb;
+            }
+            if (!stack.empty()) {
+                uf[static_cast<size_t>(u)] = stack.back().vertex;
+                up_max[static_cast<size_t>(u)] = edge_to_parent;
+            }
+        }
+    }
+
+    STATS_ADD(UfFinds, finds);
+    STATS_ADD(UfCompressions, compressions);
+
+    max_path_table_.reserve(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+        if (answers[i]) max_path_table_.insert_or_assign(queries[i].first, queries[i].second, *answers[i]);
+    v3_answers_ = std::move(answers);
 }
 
 std::optional<Weight> Graph::itineraries_v3(Vertex u, Vertex v) const {
-    Vertex a = (u < v) ? u : v;
-    Vertex b = (u < v) ? v : u;
-    auto it = max_path_table_.find({a, b});
-    if (it == max_path_table_.end()) return std::nullopt;
-    return it->second;
+    const Weight* w = max_path_table_.find(u, v);
+    if (!w) return std::nullopt;
+    return *w;
+}
+
+void Graph::build_kruskal_tree() {
+    assert(!directed && "Arbre de Kruskal pour graphe non orienté");
+    const Vertex n = num_vertices();
+    std::vector<Edge> edges = get_edges();
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge& a, const Edge& b) { return std::get<2>(a) < std::get<2>(b); });
+    // Feuilles 0..n-1 = sommets du graphe, nœuds internes n..2n-2 = unions (parent > enfant).
+    const Vertex max_nodes = n > 0 ? 2 * n - 1 : 0;
+    krt_parent_.assign(static_cast<size_t>(max_nodes), -1);
+    krt_weight_.assign(static_cast<size_t>(max_nodes), 0);
+    UnionFind uf(n);
+    std::vector<Vertex> comp_node(static_cast<size_t>(n));
+    for (Vertex v = 0; v < n; ++v) comp_node[static_cast<size_t>(v)] = v;
+    Vertex next = n;
+    for (const Edge& e : edges) {
+        if (next == max_nodes) break;
+        const Vertex ru = uf.find(std::get<0>(e)), rv = uf.find(std::get<1>(e));
+        if (ru == rv) continue;
+        const Vertex node = next++;
+        krt_parent_[static_cast<size_t>(comp_node[static_cast<size_t>(ru)])] = node;
+        krt_parent_[static_cast<size_t>(comp_node[static_cast<size_t>(rv)])] = node;
+        krt_weight_[static_cast<size_t>(node)] = std::get<2>(e);
+        uf.unite(ru, rv);
+        comp_node[static_cast<size_t>(uf.find(ru))] = node;
+    }
+    krt_parent_.resize(static_cast<size_t>(next));
+    krt_weight_.resize(static_cast<size_t>(next));
+}
+
+void Graph::build_kruskal_lifting() {
+    const Vertex next = static_cast<Vertex>(krt_parent_.size());
+    // Les parents ont un indice plus grand : un parcours décroissant suffit pour les profondeurs.
+    krt_depth_.assign(static_cast<size_t>(next), 0);
+    for (Vertex x = next - 1; x >= 0; --x) {
+        const Vertex p = krt_parent_[static_cast<size_t>(x)];
+        if (p >= 0) krt_depth_[static_cast<size_t>(x)] = krt_depth_[static_cast<size_t>(p)] + 1;
+    }
+    Vertex max_depth = 0;
+    for (Vertex d : krt_depth_) max_depth = std::max(max_depth, d);
+    int levels = 1;
+    while ((Vertex{1} << levels) <= max_depth) ++levels;
+    // Tables niveau par niveau, contiguës : krt_up_[k * N + x] = 2^k-ième ancêtre de x.
+    krt_levels_ = levels;
+    krt_up_.assign(static_cast<size_t>(levels) * static_cast<size_t>(next), -1);
+    std::copy(krt_parent_.begin(), krt_parent_.end(), krt_up_.begin());
+    for (int k = 1; k < levels; ++k) {
+        const Vertex* prev = krt_up_.data() + static_cast<size_t>(k - 1) * static_cast<size_t>(next);
+        Vertex* cur = krt_up_.data() + static_cast<size_t>(k) * static_cast<size_t>(next);
+        for (Vertex x = 0; x < next; ++x) {
+            const Vertex mid = prev[x];
+            cur[x] = mid >= 0 ? prev[mid] : -1;
+        }
+    }
+}
+
+void Graph::preprocess_itineraries_v4() {
+    build_kruskal_tree();
+    build_kruskal_lifting();
+    krt_valid_ = true;
+}
+
+std::optional<Weight> Graph::itineraries_v4(Vertex u, Vertex v) const {
+    if (!krt_valid_ || !is_alive(u) || !is_alive(v)) return std::nullopt;
+    if (u == v) return 0;
+    if (krt_depth_[static_cast<size_t>(u)] < krt_depth_[static_cast<size_t>(v)]) std::swap(u, v);
+    Vertex d = krt_depth_[static_cast<size_t>(u)] - krt_depth_[static_cast<size_t>(v)];
+    const size_t N = krt_parent_.size();
+    const Vertex* up = krt_up_.data();
+    for (int k = krt_levels_ - 1; k >= 0 && d > 0; --k)
+        if (d >= (Vertex{1} << k)) {
+            u = up[static_cast<size_t>(k) * N + static_cast<size_t>(u)];
+            d -= (Vertex{1} << k);
+        }
+    if (u != v) {
+        for (int k = krt_levels_ - 1; k >= 0; --k) {
+            const Vertex au = up[static_cast<size_t>(k) * N + static_cast<size_t>(u)];
+            const Vertex av = up[static_cast<size_t>(k) * N + static_cast<size_t>(v)];
+            if (au != av) {
+                u = au;
+                v = av;
+            }
+        }
+        u = up[static_cast<size_t>(u)];
+        if (u < 0) return std::nullopt;  // composantes différentes
+    }
+    return krt_weight_[static_cast<size_t>(u)];
+}
+
+namespace {
+inline int floor_log2(uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#else
+    int k = 0;
+    while (x >>= 1) ++k;
+    return k;
+#endif
+}
+}  // namespace
+
+void Graph::preprocess_itineraries_v5() {
+    build_kruskal_tree();
+    const Vertex n = num_vertices();
+    const Vertex nodes = static_cast<Vertex>(krt_parent_.size());
+    // Chaque nœud interne a exactement deux enfants.
+    std::vector<Vertex> child(2 * static_cast<size_t>(nodes > n ? nodes - n : 0), -1);
+    for (Vertex x = 0; x < nodes; ++x) {
+        const Vertex p = krt_parent_[static_cast<size_t>(x)];
+        if (p < 0) continue;
+        const size_t slot = 2 * static_cast<size_t>(p - n);
+        child[child[slot] < 0 ? slot : slot + 1] = x;
+    }
+    // Parcours infixe : entre deux feuilles consécutives on rencontre exactement leur LCA,
+    // et les poids croissent vers la racine, donc poids(LCA(u, v)) = max des écarts entre u et v.
+    rmq_pos_.assign(static_cast<size_t>(n), -1);
+    rmq_comp_.assign(static_cast<size_t>(n), -1);
+    std::vector<Weight> gaps(n > 1 ? static_cast<size_t>(n - 1) : 0, std::numeric_limits<Weight>::lowest());
+    std::vector<Vertex> stack;
+    Vertex leaves = 0;
+    for (Vertex root = nodes - 1; root >= 0; --root) {
+        if (krt_parent_[static_cast<size_t>(root)] >= 0) continue;
+        Vertex cur = root;
+        while (cur >= 0 || !stack.empty()) {
+            while (cur >= n) {
+                stack.push_back(cur);
+                cur = child[2 * static_cast<size_t>(cur - n)];
+            }
+            if (cur >= 0) {
+                rmq_pos_[static_cast<size_t>(cur)] = leaves++;
+                rmq_comp_[static_cast<size_t>(cur)] = root;
+                cur = -1;
+                continue;
+            }
+            const Vertex x = stack.back();
+            stack.pop_back();
+            gaps[static_cast<size_t>(leaves - 1)] = krt_weight_[static_cast<size_t>(x)];
+            cur = child[2 * static_cast<size_t>(x - n) + 1];
+        }
+    }
+    const size_t len = gaps.size();
+    const int levels = len > 0 ? floor_log2(len) + 1 : 0;
+    rmq_stride_ = len;
+    rmq_table_.resize(static_cast<size_t>(levels) * rmq_stride_);
+    std::copy(gaps.begin(), gaps.end(), rmq_table_.begin());
+    for (int k = 1; k < levels; ++k) {
+        const Weight* prev = rmq_table_.data() + static_cast<size_t>(k - 1) * rmq_stride_;
+        Weight* cur = rmq_table_.data() + static_cast<size_t>(k) * rmq_stride_;
+        const size_t half = size_t{1} << (k - 1);
+        for (size_t i = 0; i + (size_t{1} << k) <= len; ++i)
+            cur[i] = prev[i] > prev[i + half] ? prev[i] : prev[i + half];
+    }
+    rmq_valid_ = true;
+}
+
+std::optional<Weight> Graph::itineraries_v5(Vertex u, Vertex v) const {
+    if (!rmq_valid_ || !is_alive(u) || !is_alive(v)) return std::nullopt;
+    if (u == v) return 0;
+    if (rmq_comp_[static_cast<size_t>(u)] != rmq_comp_[static_cast<size_t>(v)]) return std::nullopt;
+    Vertex a = rmq_pos_[static_cast<size_t>(u)], b = rmq_pos_[static_cast<size_t>(v)];
+    if (a > b) std::swap(a, b);
+    const int k = floor_log2(static_cast<uint64_t>(b - a));
+    const Weight* row = rmq_table_.data() + static_cast<size_t>(k) * rmq_stride_;
+    const Weight w1 = row[a], w2 = row[b - (Vertex{1} << k)];
+    return w1 > w2 ? w1 : w2;
 }
 
 Vertex Graph::add_vertex() {
     center_valid_ = false;
+    krt_valid_ = false;
+    rmq_valid_ = false;
     if (!free_vertices.empty()) {
-        int v = free_vertices.back();
+        const Vertex v = free_vertices.back();
         free_vertices.pop_back();
         alive[v] = 1;
         return v;
     } else {
         cont.emplace_back();
         alive.push_back(1);
-        return cont.size() - 1;
+        return static_cast<Vertex>(cont.size()) - 1;
     }
 }
 
@@ -554,11 +1004,14 @@ void Graph::delete_edge(Vertex u, Vertex v, std::optional<Weight> w)
 {
     assert(0 <= u && u < num_vertices() && 0 <= v && v < num_vertices());
     center_valid_ = false;
+    krt_valid_ = false;
+    rmq_valid_ = false;
     max_path_table_.clear();
+    v3_answers_.clear();
     auto match = [&](const std::pair<Vertex, Weight>& e) {
         if (e.first != v) return false;
         if (!w) return true;
-        return std::fabs(e.second - *w) <= 1e-12;
+        return weights_equal(e.second, *w);
     };
 
     auto& adj_u = cont[u];
@@ -568,7 +1021,7 @@ void Graph::delete_edge(Vertex u, Vertex v, std::optional<Weight> w)
         auto match_rev = [&](const std::pair<Vertex, Weight>& e) {
             if (e.first != u) return false;
             if (!w) return true;
-            return std::fabs(e.second - *w) <= 1e-12;
+            return weights_equal(e.second, *w);
         };
 
         auto& adj_v = cont[v];
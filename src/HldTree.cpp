@@ -0,0 +1,296 @@
+#include "HldTree.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+HldTree HldTree::from_graph(const Graph& g) {
+    HldTree t;
+    t.n_ = g.num_vertices();
+    for (const auto& [u, v, w] : g.get_edges()) t.edges_.push_back({u, v, w, false});
+
+    std::vector<EdgeIndex> order(t.edges_.size());
+    std::iota(order.begin(), order.end(), EdgeIndex{0});
+    std::stable_sort(order.begin(), order.end(), [&](EdgeIndex a, EdgeIndex b) {
+        return t.edges_[static_cast<size_t>(a)].w < t.edges_[static_cast<size_t>(b)].w;
+    });
+    UnionFind uf(t.n_);
+    for (EdgeIndex e : order) {
+        EdgeRec& r = t.edges_[static_cast<size_t>(e)];
+        if (uf.find(r.u) != uf.find(r.v)) {
+            uf.unite(r.u, r.v);
+            r.in_tree = true;
+            ++t.tree_edge_count_;
+            t.total_weight_ += r.w;
+        } else {
+            t.non_tree_.emplace(r.w, e);
+        }
+    }
+    // Arêtes parallèles chaînées par indice croissant (insertion en ordre inverse).
+    t.by_pair_.reserve(t.edges_.size());
+    t.next_parallel_.assign(t.edges_.size(), -1);
+    for (size_t e = t.edges_.size(); e-- > 0;) {
+        const EdgeRec& r = t.edges_[e];
+        if (const EdgeIndex* first = t.by_pair_.find(r.u, r.v)) t.next_parallel_[e] = *first;
+        t.by_pair_.insert_or_assign(r.u, r.v, static_cast<EdgeIndex>(e));
+    }
+    // Arêtes incidentes en CSR (fixes : seuls in_tree et les poids changent ensuite) ; boucle comptée une fois.
+    const size_t n = static_cast<size_t>(t.n_);
+    t.incident_offset_.assign(n + 1, 0);
+    for (const EdgeRec& r : t.edges_) {
+        ++t.incident_offset_[static_cast<size_t>(r.u) + 1];
+        if (r.v != r.u) ++t.incident_offset_[static_cast<size_t>(r.v) + 1];
+    }
+    for (size_t i = 0; i < n; ++i) t.incident_offset_[i + 1] += t.incident_offset_[i];
+    t.incident_.resize(static_cast<size_t>(t.incident_offset_[n]));
+    {
+        std::vector<EdgeIndex> fill(t.incident_offset_.begin(), t.incident_offset_.end() - 1);
+        for (size_t e = 0; e < t.edges_.size(); ++e) {
+            const EdgeRec& r = t.edges_[e];
+            t.incident_[static_cast<size_t>(fill[static_cast<size_t>(r.u)]++)] = static_cast<EdgeIndex>(e);
+            if (r.v != r.u) t.incident_[static_cast<size_t>(fill[static_cast<size_t>(r.v)]++)] = static_cast<EdgeIndex>(e);
+        }
+    }
+    t.tree_adj_.assign(n, {});
+    for (size_t e = 0; e < t.edges_.size(); ++e) {
+        const EdgeRec& r = t.edges_[e];
+        if (!r.in_tree) continue;
+        t.tree_adj_[static_cast<size_t>(r.u)].emplace_back(r.v, static_cast<EdgeIndex>(e));
+        t.tree_adj_[static_cast<size_t>(r.v)].emplace_back(r.u, static_cast<EdgeIndex>(e));
+    }
+    t.rebuild();
+    return t;
+}
+
+void HldTree::rebuild() {
+    const size_t n = static_cast<size_t>(n_);
+    parent_.assign(n, -1);
+    parent_edge_.assign(n, -1);
+    depth_.assign(n, -1);
+    root_.assign(n, -1);
+    size_.assign(n, 1);
+    heavy_.assign(n, -1);
+    head_.assign(n, -1);
+    pos_.assign(n, -1);
+    vertex_at_.assign(n, -1);
+    value_.assign(n, std::numeric_limits<Weight>::lowest());
+    Vertex next = 0;
+    for (Vertex s = 0; s < n_; ++s) {
+        if (depth_[static_cast<size_t>(s)] >= 0) continue;
+        decompose(s, next);
+        next += size_[static_cast<size_t>(s)];
+    }
+    seg_.assign(2 * n, -1);
+    refresh_range(0, n_);
+}
+
+void HldTree::decompose(Vertex s, Vertex first) {
+    // BFS depuis s : parent, profondeur, racine ; tailles de sous-arbre en ordre inverse.
+    std::vector<Vertex> order{s};
+    depth_[static_cast<size_t>(s)] = 0;
+    root_[static_cast<size_t>(s)] = s;
+    parent_[static_cast<size_t>(s)] = -1;
+    parent_edge_[static_cast<size_t>(s)] = -1;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Vertex x = order[i];
+        for (const auto& [y, e] : tree_adj_[static_cast<size_t>(x)]) {
+            if (depth_[static_cast<size_t>(y)] >= 0) continue;
+            depth_[static_cast<size_t>(y)] = depth_[static_cast<size_t>(x)] + 1;
+            parent_[static_cast<size_t>(y)] = x;
+            parent_edge_[static_cast<size_t>(y)] = e;
+            root_[static_cast<size_t>(y)] = s;
+            order.push_back(y);
+        }
+    }
+    for (size_t i = order.size(); i-- > 1;) {
+        const Vertex x = order[i];
+        const Vertex p = parent_[static_cast<size_t>(x)];
+        size_[static_cast<size_t>(p)] += size_[static_cast<size_t>(x)];
+        Vertex& h = heavy_[static_cast<size_t>(p)];
+        if (h < 0 || size_[static_cast<size_t>(x)] > size_[static_cast<size_t>(h)]) h = x;
+    }
+
+    // Positions : chaque chaîne lourde d'un bloc, puis les sous-arbres légers (pile) ; le sous-arbre de v
+    // occupe [pos[v], pos[v] + size[v]).
+    Vertex next = first;
+    std::vector<Vertex> stack{s};
+    while (!stack.empty()) {
+        const Vertex h = stack.back();
+        stack.pop_back();
+        for (Vertex x = h; x >= 0; x = heavy_[static_cast<size_t>(x)]) {
+            head_[static_cast<size_t>(x)] = h;
+            pos_[static_cast<size_t>(x)] = next;
+            vertex_at_[static_cast<size_t>(next)] = x;
+            const EdgeIndex e = parent_edge_[static_cast<size_t>(x)];
+            value_[static_cast<size_t>(next)] = e >= 0 ? edges_[static_cast<size_t>(e)].w : std::numeric_limits<Weight>::lowest();
+            ++next;
+            for (const auto& adj : tree_adj_[static_cast<size_t>(x)]) {
+                const Vertex y = adj.first;
+                if (parent_[static_cast<size_t>(y)] == x && y != heavy_[static_cast<size_t>(x)]) stack.push_back(y);
+            }
+        }
+    }
+}
+
+void HldTree::refresh_range(Vertex l, Vertex r) {
+    const size_t n = static_cast<size_t>(n_);
+    if (l >= r) return;
+    for (size_t p = static_cast<size_t>(l); p < static_cast<size_t>(r); ++p) seg_[n + p] = static_cast<Vertex>(p);
+    // Niveau par niveau : les ancêtres de [l, r) forment un intervalle [a, b] à chaque niveau. Parcours
+    // décroissant : si n n'est pas une puissance de 2, un nœud peut avoir un enfant dans le même intervalle.
+    for (size_t a = (static_cast<size_t>(l) + n) >> 1, b = (static_cast<size_t>(r - 1) + n) >> 1; a >= 1; a >>= 1, b >>= 1)
+        for (size_t i = b + 1; i-- > a;) seg_[i] = better(seg_[2 * i], seg_[2 * i + 1]);
+}
+
+void HldTree::set_value(Vertex p, Weight w) {
+    const size_t n = static_cast<size_t>(n_);
+    value_[static_cast<size_t>(p)] = w;
+    for (size_t i = (static_cast<size_t>(p) + n) >> 1; i >= 1; i >>= 1) seg_[i] = better(seg_[2 * i], seg_[2 * i + 1]);
+}
+
+Vertex HldTree::range_max(Vertex l, Vertex r) const {
+    Vertex best = -1;
+    for (size_t a = static_cast<size_t>(l + n_), b = static_cast<size_t>(r + n_); a < b; a >>= 1, b >>= 1) {
+        if (a & 1) best = better(best, seg_[a++]);
+        if (b & 1) best = better(best, seg_[--b]);
+    }
+    return best;
+}
+
+Vertex HldTree::path_max_pos(Vertex u, Vertex v) const {
+    if (root_[static_cast<size_t>(u)] != root_[static_cast<size_t>(v)]) return -1;
+    Vertex best = -1;
+    // Remonte la chaîne dont la tête est la plus profonde jusqu'à ce que u et v partagent une chaîne.
+    while (head_[static_cast<size_t>(u)] != head_[static_cast<size_t>(v)]) {
+        if (depth_[static_cast<size_t>(head_[static_cast<size_t>(u)])] < depth_[static_cast<size_t>(head_[static_cast<size_t>(v)])])
+            std::swap(u, v);
+        const Vertex h = head_[static_cast<size_t>(u)];
+        best = better(best, range_max(pos_[static_cast<size_t>(h)], pos_[static_cast<size_t>(u)] + 1));
+        u = parent_[static_cast<size_t>(h)];
+    }
+    if (u != v) {
+        if (depth_[static_cast<size_t>(u)] > depth_[static_cast<size_t>(v)]) std::swap(u, v);
+        // u est le LCA : son arête parent n'est pas sur le chemin.
+        best = better(best, range_max(pos_[static_cast<size_t>(u)] + 1, pos_[static_cast<size_t>(v)] + 1));
+    }
+    return best;
+}
+
+std::optional<Weight> HldTree::query(Vertex u, Vertex v) const {
+    if (u < 0 || u >= n_ || v < 0 || v >= n_) return std::nullopt;
+    if (u == v) return 0;
+    if (root_[static_cast<size_t>(u)] != root_[static_cast<size_t>(v)]) return std::nullopt;
+    return value_[static_cast<size_t>(path_max_pos(u, v))];
+}
+
+HldTree::Update HldTree::update_edge_weight(Vertex u, Vertex v, Weight w) {
+    if (u < 0 || u >= n_ || v < 0 || v >= n_) return Update::NotFound;
+    const EdgeIndex* first = by_pair_.find(u, v);
+    if (!first) return Update::NotFound;
+    EdgeIndex e = *first;
+    for (EdgeIndex f = e; f >= 0 && !edges_[static_cast<size_t>(e)].in_tree; f = next_parallel_[static_cast<size_t>(f)])
+        if (edges_[static_cast<size_t>(f)].in_tree) e = f;
+    EdgeRec& r = edges_[static_cast<size_t>(e)];
+    const Weight old = r.w;
+
+    if (!r.in_tree) {
+        non_tree_.erase({old, e});
+        r.w = w;
+        non_tree_.emplace(w, e);
+        if (!(w < old)) return Update::Updated;
+        // Propriété de cycle : l'arête entre si elle est plus légère que le max du chemin qu'elle ferme.
+        const Vertex p = path_max_pos(r.u, r.v);
+        if (p < 0 || !(w < value_[static_cast<size_t>(p)])) return Update::Updated;
+        swap_edges(e, parent_edge_[static_cast<size_t>(vertex_at_[static_cast<size_t>(p)])]);
+        return Update::Swapped;
+    }
+
+    r.w = w;
+    total_weight_ += w - old;
+    const Vertex child = parent_edge_[static_cast<size_t>(r.u)] == e ? r.u : r.v;
+    set_value(pos_[static_cast<size_t>(child)], w);
+    if (!(w > old)) return Update::Updated;
+    // Propriété de coupe : la plus légère des arêtes qui traversent la coupe (sous-arbre de child) doit être e.
+    const EdgeIndex f = replacement_edge(child, old, w);
+    if (f < 0) return Update::Updated;
+    swap_edges(f, e);
+    return Update::Swapped;
+}
+
+EdgeIndex HldTree::replacement_edge(Vertex child, Weight old, Weight w) const {
+    const Vertex root = root_[static_cast<size_t>(child)];
+    const Vertex lo = pos_[static_cast<size_t>(root)], hi = lo + size_[static_cast<size_t>(root)];
+    const Vertex cl = pos_[static_cast<size_t>(child)], ch = cl + size_[static_cast<size_t>(child)];
+    auto crosses = [&](const EdgeRec& f) { return in_subtree(child, f.u) != in_subtree(child, f.v); };
+
+    // Côté : positions du sous-arbre, ou du reste de l'arbre (deux intervalles) s'il est plus petit.
+    const bool inside = 2 * (ch - cl) <= hi - lo;
+    const std::pair<Vertex, Vertex> side[2] = {inside ? std::make_pair(cl, ch) : std::make_pair(lo, cl),
+                                         inside ? std::make_pair(ch, ch) : std::make_pair(ch, hi)};
+    size_t s = 0;
+    Vertex p = side[0].first;
+    EdgeIndex k = 0, k_end = 0, best = -1;
+    // Un pas du parcours par côté : une arête incidente ; false quand le côté est épuisé.
+    auto side_step = [&]() {
+        while (k == k_end) {
+            while (p == side[s].second) {
+                if (++s == 2) return false;
+                p = side[s].first;
+            }
+            const Vertex x = vertex_at_[static_cast<size_t>(p++)];
+            k = incident_offset_[static_cast<size_t>(x)];
+            k_end = incident_offset_[static_cast<size_t>(x) + 1];
+        }
+        const EdgeIndex e = incident_[static_cast<size_t>(k++)];
+        const EdgeRec& f = edges_[static_cast<size_t>(e)];
+        if (!f.in_tree && f.w < w && crosses(f) &&
+            (best < 0 || std::make_pair(f.w, e) < std::make_pair(edges_[static_cast<size_t>(best)].w, best)))
+            best = e;
+        return true;
+    };
+    for (auto it = non_tree_.lower_bound({old, std::numeric_limits<EdgeIndex>::min()});; ++it) {
+        if (it == non_tree_.end() || !(it->first < w)) return -1;
+        if (crosses(edges_[static_cast<size_t>(it->second)])) return it->second;
+        if (!side_step()) return best;
+    }
+}
+
+void HldTree::swap_edges(EdgeIndex enter, EdgeIndex leave) {
+    EdgeRec& a = edges_[static_cast<size_t>(enter)];
+    EdgeRec& b = edges_[static_cast<size_t>(leave)];
+    non_tree_.erase({a.w, enter});
+    non_tree_.emplace(b.w, leave);
+    a.in_tree = true;
+    b.in_tree = false;
+    total_weight_ += a.w - b.w;
+    ++rebuilds_;
+    auto unlink = [&](Vertex x) {
+        auto& adj = tree_adj_[static_cast<size_t>(x)];
+        adj.erase(std::find_if(adj.begin(), adj.end(), [&](const std::pair<Vertex, EdgeIndex>& y) { return y.second == leave; }));
+    };
+    unlink(b.u);
+    unlink(b.v);
+    tree_adj_[static_cast<size_t>(a.u)].emplace_back(a.v, enter);
+    tree_adj_[static_cast<size_t>(a.v)].emplace_back(a.u, enter);
+
+    // Les deux arêtes relient des sommets du même arbre : ses sommets restent les mêmes, sur le même
+    // intervalle de positions, qu'on redécompose depuis la même racine.
+    const Vertex root = root_[static_cast<size_t>(b.u)];
+    const Vertex lo = pos_[static_cast<size_t>(root)], hi = lo + size_[static_cast<size_t>(root)];
+    for (Vertex p = lo; p < hi; ++p) {
+        const size_t x = static_cast<size_t>(vertex_at_[static_cast<size_t>(p)]);
+        depth_[x] = -1;
+        size_[x] = 1;
+        heavy_[x] = -1;
+    }
+    decompose(root, lo);
+    refresh_range(lo, hi);
+}
+
+std::vector<Edge> HldTree::edges() const {
+    std::vector<Edge> out;
+    out.reserve(tree_edge_count_);
+    for (const EdgeRec& r : edges_)
+        if (r.in_tree) out.emplace_back(r.u, r.v, r.w);
+    return out;
+}
@@ -1,55 +1,256 @@
 #include "ItinerariesTest.h"
+#include "FastInput.h"
+#include "OutputBuffer.h"
+#include "Stats.h"
+#include "TreeIndex.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 
 ItinerariesTest::ItinerariesTest(Graph tree, std::vector<std::pair<Vertex, Vertex>> queries)
-    : tree_(std::move(tree)), queries_(std::move(queries)) {}
+    : tree_(std::make_shared<Graph>(std::move(tree))), queries_(std::move(queries)) {}
+
+Graph& ItinerariesTest::mutable_tree() {
+    if (tree_.use_count() > 1) tree_ = std::make_shared<Graph>(*tree_);
+    return *tree_;
+}
 
 std::optional<ItinerariesTest> ItinerariesTest::load_from_file(const std::string& path) {
-    std::ifstream f(path);
-    if (!f) return std::nullopt;
-    int n = 0, m = 0;
-    if (!(f >> n >> m)) return std::nullopt;
+    using Clock = std::chrono::high_resolution_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+    auto t0 = Clock::now();
+    auto file = MappedFile::open(path);
+    if (!file) return std::nullopt;
+    Scanner in(file->data(), file->data() + file->size());
+    Vertex n = 0;
+    EdgeIndex m = 0;
+    if (!in.next_int(n) || !in.next_int(m)) return std::nullopt;
     if (n < 1 || m < 0) return std::nullopt;
 
-    Graph g;
-    for (int i = 0; i < n; ++i) g.add_vertex();
-    for (int i = 0; i < m; ++i) {
-        int u = 0, v = 0;
+    // Une arête occupe au moins 6 octets ("u v c\n") : borne la réservation si m est aberrant.
+    std::vector<Edge> edges;
+    edges.reserve(std::min(static_cast<size_t>(m), file->size() / 6 + 1));
+    std::vector<double> raw_weights;  // mode rang : valeurs lues, codées une fois toutes connues
+    bool integral = true;             // poids tous entiers : MST par les variantes *_radix
+    for (EdgeIndex i = 0; i < m; ++i) {
+        Vertex u = 0, v = 0;
         Weight c = 0;
-        if (!(f >> u >> v >> c)) return std::nullopt;
+        if constexpr (WEIGHT_IS_RANK) {
+            double raw = 0;
+            if (!in.next_int(u) || !in.next_int(v) || !in.next_double(raw)) return std::nullopt;
+            raw_weights.push_back(raw);
+        } else {
+            if (!in.next_int(u) || !in.next_int(v) || !in.next_weight(c)) return std::nullopt;
+            integral = integral && is_integral_weight(c);
+        }
         if (u < 1 || u > n || v < 1 || v > n) return std::nullopt;
-        g.add_edge(u - 1, v - 1, c);
+        edges.emplace_back(u - 1, v - 1, c);
     }
-    if (m != n - 1) {
-        g = g.prim(0);
+    WeightCodec codec;
+    if constexpr (WEIGHT_IS_RANK) {
+        auto ranks = WeightCodec::from_values(raw_weights);
+        if (!ranks) return std::nullopt;
+        codec = std::move(*ranks);
+        for (size_t i = 0; i < edges.size(); ++i) std::get<2>(edges[i]) = codec.encode(raw_weights[i]);
+        raw_weights = std::vector<double>();
     }
 
     int Q = 0;
-    if (!(f >> Q)) return std::nullopt;
+    if (!in.next_int(Q)) return std::nullopt;
     if (Q < 0) return std::nullopt;
     std::vector<std::pair<Vertex, Vertex>> queries;
-    queries.reserve(static_cast<size_t>(Q));
+    queries.reserve(std::min(static_cast<size_t>(Q), file->size() / 4 + 1));
     for (int i = 0; i < Q; ++i) {
-        int u = 0, v = 0;
-        if (!(f >> u >> v)) return std::nullopt;
+        Vertex u = 0, v = 0;
+        if (!in.next_int(u) || !in.next_int(v)) return std::nullopt;
         if (u < 1 || u > n || v < 1 || v > n) return std::nullopt;
         queries.emplace_back(u - 1, v - 1);
     }
+    auto t1 = Clock::now();
 
-    return ItinerariesTest(std::move(g), std::move(queries));
+    Graph g = Graph::from_edges(n, edges);
+    edges = std::vector<Edge>();
+    auto t2 = Clock::now();
+    std::string mst;
+    std::shared_ptr<Graph> input;
+    if (m != n - 1) {
+        const char* engine = std::getenv("MST");
+        const char* radix = std::getenv("RADIX");
+        const bool use_radix = integral && !(radix && std::strcmp(radix, "0") == 0);
+        mst = (engine && *engine) ? engine : "prim";
+        Graph tree;
+        if (mst == "kruskal") {
+            tree = use_radix ? g.kruskal_radix() : g.kruskal();
+        } else if (mst == "boruvka") {
+            const char* th = std::getenv("THREADS");
+            tree = g.boruvka(th ? std::atoi(th) : 0);
+        } else {
+            mst = "prim";
+            tree = use_radix ? g.prim_radix(0) : g.prim(0);
+        }
+        if (use_radix && mst != "boruvka") mst += " radix";
+        // Graphe lu gardé pour v4, qui construit son arbre de reconstruction sans passer par le MST.
+        input = std::make_shared<Graph>(std::move(g));
+        g = std::move(tree);
+    }
+    auto t3 = Clock::now();
+
+    ItinerariesTest test(std::move(g), std::move(queries));
+    test.input_ = std::move(input);
+    test.codec_ = std::move(codec);
+    test.load_stats_.bytes = file->size();
+    test.load_stats_.parse_ms = std::chrono::duration_cast<Ms>(t1 - t0).count();
+    test.load_stats_.build_ms = std::chrono::duration_cast<Ms>(t2 - t1).count();
+    test.load_stats_.mst_ms = std::chrono::duration_cast<Ms>(t3 - t2).count();
+    test.load_stats_.mst = std::move(mst);
+    return test;
 }
 
 namespace {
 constexpr double QUERY_TIMEOUT_MS = 30000.0;
+
+/** Temps d'un moteur : prétraitement (NaN si aucun) et une valeur par requête. */
+struct RuntimeColumn {
+    explicit RuntimeColumn(const char* column_name) : name(column_name) {}
+    const char* name;
+    double preprocessing_ms = std::numeric_limits<double>::quiet_NaN();
+    double queries_total_ms = 0;
+    std::vector<double> query_ms;
+};
+
+/** Blocs texte lus par scripts/run_itineraries_with_output.sh ; lignes de temps omises en mode binaire. */
+void write_runtime_block(OutputBuffer& ob, const RuntimeColumn& col, const char* marker, bool with_lines) {
+    if (!std::isnan(col.preprocessing_ms)) {
+        ob.write("RUNTIME_");
+        ob.write(marker);
+        ob.write("_PREPROCESSING ");
+        ob.write_fixed(col.preprocessing_ms, 6);
+        ob.put('\n');
+    }
+    ob.write("RUNTIME_");
+    ob.write(marker);
+    ob.write("_QUERIES_START\n");
+    if (with_lines) {
+        for (double ms : col.query_ms) {
+            if (ms >= QUERY_TIMEOUT_MS)
+                ob.write("N/A\n");
+            else {
+                ob.write_fixed(ms, 6);
+                ob.put('\n');
+            }
+        }
+    }
+    ob.write("RUNTIME_");
+    ob.write(marker);
+    ob.write("_QUERIES_END\n");
+}
+
+/**
+ * Format binaire colonnaire (RUNTIMES_BIN) : en-tête "ITRT", version, nombre de colonnes, nombre de
+ * requêtes ; puis par colonne nom (8 octets), prétraitement et total (double) ; puis les colonnes
+ * de temps par requête (double, ms) les unes après les autres.
+ */
+bool write_runtime_columns(const std::string& path, const std::vector<const RuntimeColumn*>& cols, uint64_t rows) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    OutputBuffer ob(f);
+    const uint32_t header[4] = {0x54525449u /* "ITRT" */, 1u, static_cast<uint32_t>(cols.size()), 0u};
+    ob.write_bytes(header, sizeof(header));
+    ob.write_bytes(&rows, sizeof(rows));
+    for (const RuntimeColumn* c : cols) {
+        char name[8] = {};
+        std::strncpy(name, c->name, sizeof(name) - 1);
+        ob.write_bytes(name, sizeof(name));
+        ob.write_bytes(&c->preprocessing_ms, sizeof(double));
+        ob.write_bytes(&c->queries_total_ms, sizeof(double));
+    }
+    for (const RuntimeColumn* c : cols)
+        ob.write_bytes(c->query_ms.data(), c->query_ms.size() * sizeof(double));
+    return true;
+}
+/** Une réponse par ligne : poids d'origine (codec) arrondi à l'entier, -1 si aucun chemin. */
+void write_answers(const std::string& path, const std::vector<std::optional<Weight>>& answers,
+                   const WeightCodec& codec) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return;
+    OutputBuffer ob(f);
+    for (const auto& r : answers) {
+        if (r)
+            ob.write_int(std::llround(codec.decode(*r)));
+        else
+            ob.write("-1");
+        ob.put('\n');
+    }
+}
+
+/** Nombre de jetons sur la première ligne non vide : 2 pour un .in complet (« n m »), 1 pour « Q ». */
+int first_line_tokens(const char* p, const char* end) {
+    while (p != end && static_cast<unsigned char>(*p) <= ' ') ++p;
+    int tokens = 0;
+    while (p != end && *p != '\n') {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        if (p == end || *p == '\n') break;
+        ++tokens;
+        while (p != end && static_cast<unsigned char>(*p) > ' ') ++p;
+    }
+    return tokens;
+}
+}  // namespace
+
+std::optional<std::vector<std::pair<Vertex, Vertex>>> ItinerariesTest::load_queries_from_file(const std::string& path,
+                                                                                             Vertex n) {
+    auto file = MappedFile::open(path);
+    if (!file) return std::nullopt;
+    const char* begin = file->data();
+    const char* end = begin + file->size();
+    Scanner in(begin, end);
+    if (first_line_tokens(begin, end) >= 2) {
+        Vertex file_n = 0;
+        EdgeIndex m = 0;
+        if (!in.next_int(file_n) || !in.next_int(m) || file_n != n || m < 0) return std::nullopt;
+        for (EdgeIndex i = 0; i < m; ++i) {
+            Vertex u = 0, v = 0;
+            double c = 0;
+            if (!in.next_int(u) || !in.next_int(v) || !in.next_double(c)) return std::nullopt;
+        }
+    }
+    int Q = 0;
+    if (!in.next_int(Q) || Q < 0) return std::nullopt;
+    std::vector<std::pair<Vertex, Vertex>> queries;
+    queries.reserve(std::min(static_cast<size_t>(Q), file->size() / 4 + 1));
+    for (int i = 0; i < Q; ++i) {
+        Vertex u = 0, v = 0;
+        if (!in.next_int(u) || !in.next_int(v)) return std::nullopt;
+        if (u < 1 || u > n || v < 1 || v > n) return std::nullopt;
+        queries.emplace_back(u - 1, v - 1);
+    }
+    return queries;
+}
+
+void ItinerariesTest::run_with_index(const TreeIndex& index, const std::vector<std::pair<Vertex, Vertex>>& queries,
+                                     std::ostream& out, const std::optional<std::string>& answers_path) {
+    using Clock = std::chrono::high_resolution_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+    std::vector<std::optional<Weight>> res(queries.size());
+    auto t0 = Clock::now();
+    index.answer_batch(queries.data(), queries.size(), res.data());
+    auto t1 = Clock::now();
+    if (answers_path) write_answers(*answers_path, res, index.codec());
+    out << "n = " << index.num_vertices() << ", |P| = " << queries.size() << "\n";
+    out << std::fixed << std::setprecision(3);
+    out << "  itineraries_v2 (index, " << LiftingView::batch_kernel_name() << ") : requêtes "
+        << std::chrono::duration_cast<Ms>(t1 - t0).count() << " ms, sans prétraitement\n";
 }
 
 void ItinerariesTest::run_and_compare_times(std::ostream& out,
                                              const std::optional<std::string>& answers_path,
-                                             ItinerariesRuntimes* runtimes_out) const {
+                                             ItinerariesRuntimes* runtimes_out) {
     if (queries_.empty()) {
         out << "Aucune requête.\n";
         return;
@@ -57,86 +258,147 @@ void ItinerariesTest::run_and_compare_times(std::ostream& out,
     using Clock = std::chrono::high_resolution_clock;
     using Ms = std::chrono::duration<double, std::milli>;
 
-    std::vector<std::optional<Weight>> res_v1(queries_.size()), res_v2(queries_.size()), res_v3(queries_.size());
-    const int n = tree_.num_vertices();
+    std::vector<std::optional<Weight>> res_v1(queries_.size()), res_v2(queries_.size()), res_v3(queries_.size()),
+        res_v4(queries_.size()), res_v5(queries_.size());
+    const Vertex n = tree_->num_vertices();
     const bool skip_v1 = (std::getenv("SKIP_V1") && std::atoi(std::getenv("SKIP_V1")) != 0);
+    const int n_threads = std::getenv("THREADS") ? std::atoi(std::getenv("THREADS")) : 0;
+    const char* runtimes_bin = std::getenv("RUNTIMES_BIN");
+    const bool text_lines = !(runtimes_bin && *runtimes_bin);
 
-    double ms_v1_total = 0;
-    out << "RUNTIME_V1_QUERIES_START\n";
-    if (!skip_v1) {
-        Graph g1 = tree_;
+    OutputBuffer ob(out);
+    auto elapsed = [](Clock::time_point t0, Clock::time_point t1) {
+        return std::chrono::duration_cast<Ms>(t1 - t0).count();
+    };
+    auto time_queries = [&](RuntimeColumn& col, std::vector<std::optional<Weight>>& res, auto&& engine) {
+        col.query_ms.resize(queries_.size());
         for (size_t i = 0; i < queries_.size(); ++i) {
             auto t0 = Clock::now();
-            res_v1[i] = g1.itineraries_v1(queries_[i].first, queries_[i].second);
+            res[i] = engine(i, queries_[i].first, queries_[i].second);
             auto t1 = Clock::now();
-            double ms = std::chrono::duration_cast<Ms>(t1 - t0).count();
-            ms_v1_total += ms;
-            if (ms >= QUERY_TIMEOUT_MS)
-                out << "N/A\n";
-            else
-                out << std::fixed << std::setprecision(6) << ms << "\n";
+            col.query_ms[i] = elapsed(t0, t1);
+            col.queries_total_ms += col.query_ms[i];
         }
+    };
+
+    auto phase_begin = [&](const char* name) {
+        if (stats_) stats_->begin(name);
+    };
+    auto phase_end = [&] {
+        if (stats_) stats_->end();
+    };
+
+    RuntimeColumn c1("v1"), c2("v2"), c3("v3"), c4("v4"), c5("v5");
+    if (!skip_v1) {
+        const Graph& g1 = *tree_;
+        phase_begin("v1 requêtes");
+        time_queries(c1, res_v1, [&](size_t, Vertex u, Vertex v) { return g1.itineraries_v1(u, v); });
+        phase_end();
     }
-    out << "RUNTIME_V1_QUERIES_END\n";
+    write_runtime_block(ob, c1, "V1", text_lines);
 
-    Graph g2 = tree_;
+    // Les prétraitements v2 … v5 s'ajoutent à l'arbre du test, sans le recopier (v1 n'en dépend pas).
+    Graph& g2 = mutable_tree();
+    phase_begin("v2 prétraitement");
     auto t2_pre0 = Clock::now();
     g2.compute_center_and_parent();
     auto t2_pre1 = Clock::now();
-    double ms_pre_v2 = std::chrono::duration_cast<Ms>(t2_pre1 - t2_pre0).count();
+    phase_end();
+    c2.preprocessing_ms = elapsed(t2_pre0, t2_pre1);
     if (!g2.has_center()) {
-        out << "Erreur : compute_center_and_parent a échoué (graphe non connexe ?).\n";
+        ob.write("Erreur : compute_center_and_parent a échoué (graphe non connexe ?).\n");
         return;
     }
-    out << "RUNTIME_V2_PREPROCESSING " << std::fixed << std::setprecision(6) << ms_pre_v2 << "\n";
-    double ms_v2_queries_total = 0;
-    out << "RUNTIME_V2_QUERIES_START\n";
-    for (size_t i = 0; i < queries_.size(); ++i) {
+    phase_begin("v2 requêtes");
+    time_queries(c2, res_v2, [&](size_t, Vertex u, Vertex v) { return g2.itineraries_v2(u, v); });
+    phase_end();
+    write_runtime_block(ob, c2, "V2", text_lines);
+
+    double ms_v2_batch = 0;
+    std::vector<std::optional<Weight>> res_v2_batch;
+    {
+        phase_begin("v2 lot");
         auto t0 = Clock::now();
-        res_v2[i] = g2.itineraries_v2(queries_[i].first, queries_[i].second);
+        res_v2_batch = g2.answer_batch(queries_, n_threads);
         auto t1 = Clock::now();
-        double ms = std::chrono::duration_cast<Ms>(t1 - t0).count();
-        ms_v2_queries_total += ms;
-        if (ms >= QUERY_TIMEOUT_MS)
-            out << "N/A\n";
-        else
-            out << std::fixed << std::setprecision(6) << ms << "\n";
+        phase_end();
+        ms_v2_batch = elapsed(t0, t1);
     }
-    out << "RUNTIME_V2_QUERIES_END\n";
-    double ms_v2_total = ms_pre_v2 + ms_v2_queries_total;
 
-    double ms_pre_v3 = 0;
     {
+        phase_begin("v3 prétraitement");
         auto t0 = Clock::now();
         g2.preprocess_itineraries_v3(queries_);
         auto t1 = Clock::now();
-        ms_pre_v3 = std::chrono::duration_cast<Ms>(t1 - t0).count();
+        phase_end();
+        c3.preprocessing_ms = elapsed(t0, t1);
     }
-    out << "RUNTIME_V3_PREPROCESSING " << std::fixed << std::setprecision(6) << ms_pre_v3 << "\n";
-    double ms_v3_queries_total = 0;
-    out << "RUNTIME_V3_QUERIES_START\n";
-    for (size_t i = 0; i < queries_.size(); ++i) {
+    // Requêtes v3 : lecture des réponses rangées dans l'ordre des requêtes (pas de hachage).
+    const auto& v3_answers = g2.itineraries_v3_answers();
+    phase_begin("v3 requêtes");
+    time_queries(c3, res_v3, [&](size_t i, Vertex, Vertex) { return v3_answers[i]; });
+    phase_end();
+    write_runtime_block(ob, c3, "V3", text_lines);
+    // Même lot par paires (table à adressage ouvert) : temps global dans le résumé.
+    double ms_v3_table = 0;
+    bool v3_table_ok = true;
+    {
+        phase_begin("v3 table");
         auto t0 = Clock::now();
-        res_v3[i] = g2.itineraries_v3(queries_[i].first, queries_[i].second);
+        for (size_t i = 0; i < queries_.size(); ++i)
+            if (g2.itineraries_v3(queries_[i].first, queries_[i].second) != v3_answers[i]) v3_table_ok = false;
         auto t1 = Clock::now();
-        double ms = std::chrono::duration_cast<Ms>(t1 - t0).count();
-        ms_v3_queries_total += ms;
-        if (ms >= QUERY_TIMEOUT_MS)
-            out << "N/A\n";
-        else
-            out << std::fixed << std::setprecision(6) << ms << "\n";
+        phase_end();
+        ms_v3_table = elapsed(t0, t1);
+    }
+
+    // v4 sur le graphe lu s'il n'était pas un arbre : le tri et l'union-find de l'arbre de reconstruction
+    // remplacent le MST, dont le temps n'est donc pas à ajouter (comparer à MST + v2).
+    Graph& g4 = input_ ? *input_ : g2;
+    {
+        phase_begin("v4 prétraitement");
+        auto t0 = Clock::now();
+        g4.preprocess_itineraries_v4();
+        auto t1 = Clock::now();
+        phase_end();
+        c4.preprocessing_ms = elapsed(t0, t1);
+    }
+    phase_begin("v4 requêtes");
+    time_queries(c4, res_v4, [&](size_t, Vertex u, Vertex v) { return g4.itineraries_v4(u, v); });
+    phase_end();
+    write_runtime_block(ob, c4, "V4", text_lines);
+    const bool v4_on_input = input_ != nullptr;
+    input_.reset();  // plus utilisé : libère les m arêtes
+
+    {
+        phase_begin("v5 prétraitement");
+        auto t0 = Clock::now();
+        g2.preprocess_itineraries_v5();
+        auto t1 = Clock::now();
+        phase_end();
+        c5.preprocessing_ms = elapsed(t0, t1);
     }
-    out << "RUNTIME_V3_QUERIES_END\n";
-    double ms_v3_total = ms_pre_v3 + ms_v3_queries_total;
+    phase_begin("v5 requêtes");
+    time_queries(c5, res_v5, [&](size_t, Vertex u, Vertex v) { return g2.itineraries_v5(u, v); });
+    phase_end();
+    write_runtime_block(ob, c5, "V5", text_lines);
 
-    bool ok = true;
+    const double ms_v1_total = c1.queries_total_ms;
+    const double ms_v2_total = c2.preprocessing_ms + c2.queries_total_ms;
+    const double ms_v3_total = c3.preprocessing_ms + c3.queries_total_ms;
+    const double ms_v4_total = c4.preprocessing_ms + c4.queries_total_ms;
+    const double ms_v5_total = c5.preprocessing_ms + c5.queries_total_ms;
+
+    bool ok = (res_v2_batch == res_v2) && v3_table_ok;
     if (skip_v1) {
         for (size_t i = 0; i < queries_.size(); ++i) {
-            if (res_v2[i] != res_v3[i]) ok = false;
+            if (res_v2[i] != res_v3[i] || res_v2[i] != res_v4[i] || res_v2[i] != res_v5[i]) ok = false;
         }
     } else {
         for (size_t i = 0; i < queries_.size(); ++i) {
-            if (res_v1[i] != res_v2[i] || res_v1[i] != res_v3[i]) ok = false;
+            if (res_v1[i] != res_v2[i] || res_v1[i] != res_v3[i] || res_v1[i] != res_v4[i] ||
+                res_v1[i] != res_v5[i])
+                ok = false;
         }
     }
 
@@ -144,30 +406,41 @@ void ItinerariesTest::run_and_compare_times(std::ostream& out,
         runtimes_out->v1_ms = ms_v1_total;
         runtimes_out->v2_total_ms = ms_v2_total;
         runtimes_out->v3_total_ms = ms_v3_total;
+        runtimes_out->v4_total_ms = ms_v4_total;
+        runtimes_out->v5_total_ms = ms_v5_total;
         runtimes_out->results_identical = ok;
     }
 
-    if (answers_path) {
-        std::ofstream f(*answers_path);
-        if (f) {
-            const auto& ref = skip_v1 ? res_v2 : res_v1;
-            for (size_t i = 0; i < queries_.size(); ++i) {
-                const auto& r = ref[i];
-                if (r)
-                    f << static_cast<int>(std::round(*r)) << "\n";
-                else
-                    f << "-1\n";
-            }
-        }
+    if (answers_path) write_answers(*answers_path, skip_v1 ? res_v2 : res_v1, codec_);
+
+    if (!text_lines) {
+        std::vector<const RuntimeColumn*> cols;
+        if (!skip_v1) cols.push_back(&c1);
+        for (const RuntimeColumn* c : {&c2, &c3, &c4, &c5}) cols.push_back(c);
+        if (!write_runtime_columns(runtimes_bin, cols, queries_.size()))
+            ob.write("Erreur : écriture de RUNTIMES_BIN impossible.\n");
     }
 
-    out << "n = " << n << ", |P| = " << queries_.size() << "\n";
+    ob.write("n = ");
+    ob.write_int(n);
+    ob.write(", |P| = ");
+    ob.write_int(static_cast<long long>(queries_.size()));
+    ob.put('\n');
+    ob.flush();
     out << std::fixed << std::setprecision(3);
     if (skip_v1)
         out << "  itineraries_v1 : (ignoré, SKIP_V1=1)\n";
     else
         out << "  itineraries_v1 : " << ms_v1_total << " ms (requêtes uniquement, pas de prétraitement)\n";
-    out << "  itineraries_v2 : prétraitement " << ms_pre_v2 << " ms + requêtes " << ms_v2_queries_total << " ms = total " << ms_v2_total << " ms\n";
-    out << "  itineraries_v3 : prétraitement " << ms_pre_v3 << " ms + requêtes " << ms_v3_queries_total << " ms = total " << ms_v3_total << " ms\n";
+    out << "  itineraries_v2 : prétraitement " << c2.preprocessing_ms << " ms + requêtes " << c2.queries_total_ms << " ms = total " << ms_v2_total << " ms\n";
+    out << "  itineraries_v2 (lot, " << (n_threads > 0 ? std::to_string(n_threads) : std::string("tous les")) << " threads, " << LiftingView::batch_kernel_name()
+        << (g2.batch_order(queries_.size()) == BatchOrder::Curve ? ", ordre Z" : "") << ") : requêtes " << ms_v2_batch << " ms\n";
+    out << "  itineraries_v3 : prétraitement " << c3.preprocessing_ms << " ms + requêtes " << c3.queries_total_ms << " ms = total " << ms_v3_total << " ms\n";
+    out << "  itineraries_v3 (table, par paire) : requêtes " << ms_v3_table << " ms\n";
+    out << "  itineraries_v4" << (v4_on_input ? " (graphe lu, sans MST)" : "") << " : prétraitement " << c4.preprocessing_ms << " ms + requêtes " << c4.queries_total_ms << " ms = total " << ms_v4_total << " ms\n";
+    if (v4_on_input)
+        out << "  MST (" << load_stats_.mst << ") + itineraries_v2 : " << load_stats_.mst_ms + ms_v2_total
+            << " ms, à comparer à itineraries_v4\n";
+    out << "  itineraries_v5 : prétraitement " << c5.preprocessing_ms << " ms + requêtes " << c5.queries_total_ms << " ms = total " << ms_v5_total << " ms\n";
     out << "  Résultats identiques : " << (ok ? "oui" : "non") << "\n";
 }
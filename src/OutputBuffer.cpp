@@ -0,0 +1,41 @@
+#include "OutputBuffer.h"
+#include <charconv>
+#include <cstring>
+
+OutputBuffer::OutputBuffer(std::ostream& out, std::size_t capacity) : out_(out), buf_(capacity < 512 ? 512 : capacity) {}
+
+OutputBuffer::~OutputBuffer() { flush(); }
+
+void OutputBuffer::flush() {
+    if (len_ == 0) return;
+    out_.write(buf_.data(), static_cast<std::streamsize>(len_));
+    len_ = 0;
+}
+
+void OutputBuffer::write(std::string_view s) {
+    if (s.size() > buf_.size()) {
+        flush();
+        out_.write(s.data(), static_cast<std::streamsize>(s.size()));
+        return;
+    }
+    reserve(s.size());
+    std::memcpy(buf_.data() + len_, s.data(), s.size());
+    len_ += s.size();
+}
+
+void OutputBuffer::write_bytes(const void* data, std::size_t size) {
+    write(std::string_view(static_cast<const char*>(data), size));
+}
+
+void OutputBuffer::write_int(long long x) {
+    reserve(24);
+    auto res = std::to_chars(buf_.data() + len_, buf_.data() + buf_.size(), x);
+    len_ = static_cast<std::size_t>(res.ptr - buf_.data());
+}
+
+void OutputBuffer::write_fixed(double x, int precision) {
+    // Un double en notation fixe peut compter plus de 300 chiffres avant la virgule.
+    reserve(320 + static_cast<std::size_t>(precision < 0 ? 0 : precision));
+    auto res = std::to_chars(buf_.data() + len_, buf_.data() + buf_.size(), x, std::chars_format::fixed, precision);
+    len_ = static_cast<std::size_t>(res.ptr - buf_.data());
+}
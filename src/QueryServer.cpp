@@ -0,0 +1,165 @@
+#include "QueryServer.h"
+#include "QueryProtocol.h"
+#include "Stats.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+/** Connexions acceptées en attente d'un thread ; close() réveille les threads pour qu'ils terminent. */
+class ConnectionQueue
+{
+public:
+    void push(int fd) {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            fds_.push_back(fd);
+        }
+        cv_.notify_one();
+    }
+    /** -1 une fois la file fermée et vide. */
+    int pop() {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait(lock, [&] { return closed_ || !fds_.empty(); });
+        if (fds_.empty()) return -1;
+        const int fd = fds_.front();
+        fds_.pop_front();
+        return fd;
+    }
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<int> fds_;
+    bool closed_ = false;
+};
+
+/** Connexions servies en ce moment : coupées (shutdown) à l'arrêt pour débloquer les read(). */
+class ActiveConnections
+{
+public:
+    void add(int fd) {
+        std::lock_guard<std::mutex> lock(m_);
+        fds_.insert(fd);
+    }
+    void remove(int fd) {
+        std::lock_guard<std::mutex> lock(m_);
+        fds_.erase(fd);
+    }
+    void shutdown_all() {
+        std::lock_guard<std::mutex> lock(m_);
+        for (int fd : fds_) shutdown(fd, SHUT_RDWR);
+    }
+
+private:
+    std::mutex m_;
+    std::unordered_set<int> fds_;
+};
+
+/** Sommet reçu sur 64 bits ; hors de Vertex, -1 (sommet invalide : NaN) plutôt qu'une troncature. */
+Vertex from_wire(int64_t x) {
+    return x < 0 || x > std::numeric_limits<Vertex>::max() ? Vertex{-1} : static_cast<Vertex>(x);
+}
+
+void serve_connection(int fd, Vertex n_vertices, const BatchEngine& engine, const WeightCodec& codec) {
+    std::vector<protocol::QueryPair> wire;
+    std::vector<std::pair<Vertex, Vertex>> queries;
+    std::vector<std::optional<Weight>> answers;
+    std::vector<double> out;
+    for (;;) {
+        protocol::RequestHeader req;
+        if (!protocol::read_full(fd, &req, sizeof(req))) return;
+        protocol::ResponseHeader resp{protocol::RESPONSE_MAGIC, 0, n_vertices, protocol::OK, 0};
+        if (req.magic != protocol::REQUEST_MAGIC || req.count > protocol::MAX_BATCH) {
+            resp.status = protocol::BAD_REQUEST;
+            protocol::write_full(fd, &resp, sizeof(resp));
+            return;
+        }
+        wire.resize(req.count);
+        if (!protocol::read_full(fd, wire.data(), wire.size() * sizeof(protocol::QueryPair))) return;
+        queries.resize(wire.size());
+        for (size_t i = 0; i < wire.size(); ++i) queries[i] = {from_wire(wire[i].u), from_wire(wire[i].v)};
+        answers.assign(queries.size(), std::nullopt);
+        if (!queries.empty()) engine(queries, answers);
+        stats::flush();
+        out.resize(answers.size());
+        for (size_t i = 0; i < answers.size(); ++i)
+            out[i] = answers[i] ? codec.decode(*answers[i]) : std::numeric_limits<double>::quiet_NaN();
+        resp.count = req.count;
+        if (!protocol::write_full(fd, &resp, sizeof(resp)) ||
+            !protocol::write_full(fd, out.data(), out.size() * sizeof(double)))
+            return;
+    }
+}
+
+int open_listener(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return -1;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) return -1;
+        unlink(path.c_str());
+    }
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+}  // namespace
+
+bool serve_queries(const std::string& socket_path, Vertex n_vertices, const BatchEngine& engine, int n_workers,
+                   const std::atomic<bool>& stop, const WeightCodec& codec) {
+    const int listener = open_listener(socket_path);
+    if (listener < 0) return false;
+    if (n_workers <= 0) n_workers = static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+
+    ConnectionQueue pending;
+    ActiveConnections active;
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(n_workers));
+    for (int i = 0; i < n_workers; ++i)
+        workers.emplace_back([&] {
+            for (int fd; (fd = pending.pop()) >= 0;) {
+                active.add(fd);
+                if (!stop.load(std::memory_order_relaxed)) serve_connection(fd, n_vertices, engine, codec);
+                active.remove(fd);
+                close(fd);
+            }
+        });
+
+    // Attente bornée (poll) : stop est relu au moins toutes les 200 ms.
+    while (!stop.load(std::memory_order_relaxed)) {
+        pollfd p{listener, POLLIN, 0};
+        if (poll(&p, 1, 200) <= 0) continue;
+        const int fd = accept(listener, nullptr, nullptr);
+        if (fd >= 0) pending.push(fd);
+    }
+
+    close(listener);
+    unlink(socket_path.c_str());
+    pending.close();
+    active.shutdown_all();
+    for (auto& w : workers) w.join();
+    return true;
+}
@@ -0,0 +1,116 @@
+#include "QueryStream.h"
+#include "FastInput.h"
+#include "OutputBuffer.h"
+#include "SpscQueue.h"
+#include "Stats.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+/** Lot en transit ; last marque la fin de l'entrée (lot éventuellement vide). */
+struct StreamBatch {
+    std::vector<std::pair<Vertex, Vertex>> queries;
+    std::vector<std::optional<Weight>> answers;
+    bool last = false;
+};
+
+constexpr size_t QUEUE_BATCHES = 64;
+constexpr size_t READ_CHUNK = 1 << 16;
+
+/** Ligne « u v » 1-indexée ; (-1, -1) si la ligne est mal formée (réponse -1). */
+std::pair<Vertex, Vertex> parse_line(const char* begin, const char* end) {
+    Scanner in(begin, end);
+    Vertex u = 0, v = 0;
+    if (!in.next_int(u) || !in.next_int(v)) return {-1, -1};
+    return {u - 1, v - 1};
+}
+
+bool blank(const char* begin, const char* end) {
+    for (const char* p = begin; p != end; ++p)
+        if (static_cast<unsigned char>(*p) > ' ') return false;
+    return true;
+}
+
+/** Étage 1 : read() bloquant, un ou plusieurs lots par bloc lu ; la ligne incomplète attend le bloc suivant. */
+void parse_stage(int fd, SpscQueue<StreamBatch>& q, size_t max_batch) {
+    std::vector<char> buf(READ_CHUNK);
+    size_t kept = 0;
+    StreamBatch batch;
+    auto emit = [&](bool last) {
+        if (batch.queries.empty() && !last) return;
+        batch.last = last;
+        q.push(std::move(batch));
+        batch = StreamBatch();
+    };
+    auto add_line = [&](const char* b, const char* e) {
+        if (blank(b, e)) return;
+        batch.queries.push_back(parse_line(b, e));
+        if (batch.queries.size() == max_batch) emit(false);
+    };
+    for (;;) {
+        if (kept == buf.size()) buf.resize(buf.size() * 2);  // ligne plus longue que le tampon
+        const ssize_t r = read(fd, buf.data() + kept, buf.size() - kept);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        const char* begin = buf.data();
+        const char* end = begin + kept + static_cast<size_t>(r);
+        const char* line = begin;
+        for (const char* nl; (nl = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line))));
+             line = nl + 1)
+            add_line(line, nl);
+        kept = static_cast<size_t>(end - line);
+        std::memmove(buf.data(), line, kept);
+        // Lot publié dès la fin du bloc lu : la latence ne dépend pas du remplissage d'un lot.
+        emit(false);
+    }
+    if (kept > 0) add_line(buf.data(), buf.data() + kept);
+    emit(true);
+    stats::flush();
+}
+
+/** Étage 2 : réponses du lot. */
+void answer_stage(SpscQueue<StreamBatch>& in, SpscQueue<StreamBatch>& out, const BatchEngine& engine) {
+    for (;;) {
+        StreamBatch b = in.pop();
+        b.answers.assign(b.queries.size(), std::nullopt);
+        if (!b.queries.empty()) engine(b.queries, b.answers);
+        stats::flush();
+        const bool last = b.last;
+        out.push(std::move(b));
+        if (last) return;
+    }
+}
+}  // namespace
+
+StreamStats run_query_stream(int in_fd, std::ostream& out, const BatchEngine& engine, const WeightCodec& codec,
+                             size_t max_batch) {
+    if (max_batch == 0) max_batch = 1;
+    SpscQueue<StreamBatch> parsed(QUEUE_BATCHES), answered(QUEUE_BATCHES);
+    std::thread parser(parse_stage, in_fd, std::ref(parsed), max_batch);
+    std::thread answerer(answer_stage, std::ref(parsed), std::ref(answered), std::cref(engine));
+
+    // Étage 3 (thread appelant) : formatage et écriture, vidage après chaque lot.
+    StreamStats stats;
+    OutputBuffer ob(out);
+    for (;;) {
+        StreamBatch b = answered.pop();
+        for (const auto& r : b.answers) {
+            if (r)
+                ob.write_int(std::llround(codec.decode(*r)));
+            else
+                ob.write("-1");
+            ob.put('\n');
+        }
+        ob.flush();
+        out.flush();
+        stats.queries += b.answers.size();
+        if (!b.answers.empty()) ++stats.batches;
+        if (b.last) break;
+    }
+    parser.join();
+    answerer.join();
+    return stats;
+}
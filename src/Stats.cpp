@@ -0,0 +1,169 @@
+#include "Stats.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace stats {
+
+const char* counter_name(Counter c) {
+    switch (c) {
+    case LiftJumps: return "lift_jumps";
+    case V1Visited: return "v1_visited";
+    case UfFinds: return "uf_finds";
+    case UfCompressions: return "uf_compressions";
+    case HeapPushes: return "heap_pushes";
+    case HeapPops: return "heap_pops";
+    case HashProbes: return "hash_probes";
+    case AllocCount: return "allocs";
+    case AllocBytes: return "alloc_bytes";
+    case NUM_COUNTERS: break;
+    }
+    return "?";
+}
+
+void flush() {
+#ifdef ITINERARIES_STATS
+    for (int i = 0; i < NUM_COUNTERS; ++i) {
+        if (!local_counters[i]) continue;
+        counters[i].fetch_add(local_counters[i], std::memory_order_relaxed);
+        local_counters[i] = 0;
+    }
+#endif
+}
+
+std::vector<uint64_t> snapshot() {
+    flush();
+    std::vector<uint64_t> v(NUM_COUNTERS, 0);
+#ifdef ITINERARIES_STATS
+    for (int i = 0; i < NUM_COUNTERS; ++i) v[static_cast<size_t>(i)] = counters[i].load(std::memory_order_relaxed);
+#endif
+    return v;
+}
+
+namespace {
+#ifdef __linux__
+int open_counter(uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;  // threads de answer_batch / Borůvka
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+}  // namespace
+
+HardwareCounters::HardwareCounters() {
+#ifdef __linux__
+    const uint64_t configs[COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+                                     PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < COUNT; ++i) fds_[i] = open_counter(configs[i]);
+#else
+    for (int& fd : fds_) fd = -1;
+#endif
+}
+
+HardwareCounters::~HardwareCounters() {
+#ifdef __linux__
+    for (int fd : fds_)
+        if (fd >= 0) close(fd);
+#endif
+}
+
+void HardwareCounters::start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+std::vector<int64_t> HardwareCounters::stop() {
+    std::vector<int64_t> v(COUNT, -1);
+#ifdef __linux__
+    for (int i = 0; i < COUNT; ++i) {
+        if (fds_[i] < 0) continue;
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(fds_[i], &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value)))
+            v[static_cast<size_t>(i)] = static_cast<int64_t>(value);
+    }
+#endif
+    return v;
+}
+
+const char* HardwareCounters::name(int i) {
+    static const char* const names[COUNT] = {"cycles", "llc_misses", "branch_misses"};
+    return i >= 0 && i < COUNT ? names[i] : "?";
+}
+
+namespace {
+double now_ms() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}  // namespace
+
+void Report::begin(const std::string& phase) {
+    phases_.push_back({phase, 0, {}, {}});
+    start_counters_ = snapshot();
+    start_ms_ = now_ms();
+    hw_.start();
+}
+
+void Report::end() {
+    if (phases_.empty()) return;
+    std::vector<int64_t> hw = hw_.stop();
+    const double t = now_ms();
+    Phase& p = phases_.back();
+    p.ms = t - start_ms_;
+    p.hardware = std::move(hw);
+    p.counters = snapshot();
+    for (size_t i = 0; i < p.counters.size(); ++i) p.counters[i] -= start_counters_[i];
+}
+
+void Report::write(std::ostream& out) const {
+    out << "Stats par phase";
+    if (!enabled) out << " (compteurs logiciels désactivés : make clean && make STATS=1)";
+    if (!hw_.available()) out << " (compteurs matériels indisponibles : perf_event_open refusé)";
+    out << " :\n" << std::fixed << std::setprecision(3);
+    for (const Phase& p : phases_) {
+        out << "  " << p.name << " : " << p.ms << " ms";
+        for (size_t i = 0; i < p.counters.size(); ++i)
+            if (p.counters[i]) out << ", " << counter_name(static_cast<Counter>(i)) << " " << p.counters[i];
+        for (size_t i = 0; i < p.hardware.size(); ++i)
+            if (p.hardware[i] >= 0) out << ", " << HardwareCounters::name(static_cast<int>(i)) << " " << p.hardware[i];
+        out << "\n";
+    }
+}
+
+}  // namespace stats
+
+#ifdef ITINERARIES_STATS
+// Comptage des allocations : remplace les operator new / delete globaux (tailles par défaut d'alignement).
+void* operator new(std::size_t size) {
+    STATS_ADD(AllocCount, 1);
+    STATS_ADD(AllocBytes, size);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,54 @@
+#include "ThreadPool.h"
+#include "Stats.h"
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& w : workers_) w.join();
+}
+
+size_t ThreadPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workers_.size();
+}
+
+void ThreadPool::run(size_t tasks, const std::function<void(size_t)>& fn) {
+    if (tasks <= 1) {
+        if (tasks == 1) fn(0);
+        return;
+    }
+    Job job{&fn, 0, tasks, tasks};
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (workers_.size() + 1 < tasks) workers_.emplace_back([this] { worker_loop(); });
+    queue_.push_back(&job);
+    wake_.notify_all();
+    while (job.next < job.tasks) run_one(job, lock);
+    done_.wait(lock, [&job] { return job.pending == 0; });
+}
+
+void ThreadPool::run_one(Job& job, std::unique_lock<std::mutex>& lock) {
+    const size_t t = job.next++;
+    if (job.next == job.tasks) queue_.erase(std::find(queue_.begin(), queue_.end(), &job));
+    lock.unlock();
+    (*job.fn)(t);
+    stats::flush();  // avant pending : les compteurs de la tâche sont publiés quand run revient
+    lock.lock();
+    if (--job.pending == 0) done_.notify_all();
+}
+
+void ThreadPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (stop_) return;
+        run_one(*queue_.front(), lock);
+    }
+}
@@ -0,0 +1,228 @@
+#include "TreeIndex.h"
+#include "OutputBuffer.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr char MAGIC[8] = {'M', 'P', 'I', 'T', 'I', 'D', 'X', '\0'};
+
+uint64_t align_up(uint64_t x) {
+    return (x + TreeIndex::ALIGNMENT - 1) / TreeIndex::ALIGNMENT * TreeIndex::ALIGNMENT;
+}
+
+/** Complète avec des zéros jusqu'à la position alignée suivante. */
+void pad_to(OutputBuffer& ob, uint64_t& pos, uint64_t target) {
+    static const char zeros[TreeIndex::ALIGNMENT] = {};
+    if (target > pos) ob.write_bytes(zeros, static_cast<size_t>(target - pos));
+    pos = target;
+}
+
+/** En-tête des versions 1 et 2 : champs sur 32 bits, depth en int[n]. */
+struct LegacyHeader {
+    char magic[8];
+    uint32_t version;
+    uint16_t weight_size;
+    uint16_t vertex_size;
+    uint32_t n;
+    int32_t levels;
+    int32_t centre;
+    int32_t diameter_length;
+    uint64_t alive_offset;
+    uint64_t parent_offset;
+    uint64_t weight_offset;
+    uint64_t depth_offset;
+    uint64_t lift_offset;
+    uint64_t file_size;
+    uint64_t codec_offset;
+    uint64_t codec_count;
+    uint32_t weight_kind;
+    uint32_t unused;
+    uint64_t label_offset;
+    uint64_t reserved[2];
+};
+static_assert(sizeof(LegacyHeader) == sizeof(TreeIndexHeader), "les deux en-têtes font 128 octets");
+
+/** En-tête version 3 équivalent ; depth (int[n]) n'est lisible tel quel que si Vertex est int. */
+std::optional<TreeIndexHeader> from_legacy(const LegacyHeader& old) {
+    if (old.vertex_size != sizeof(int) || sizeof(Vertex) != sizeof(int)) return std::nullopt;
+    TreeIndexHeader h{};
+    std::memcpy(h.magic, old.magic, sizeof(h.magic));
+    h.version = old.version;
+    h.weight_size = old.weight_size;
+    h.vertex_size = old.vertex_size;
+    h.n = old.n;
+    h.centre = old.centre;
+    h.diameter_length = old.diameter_length;
+    h.levels = old.levels;
+    h.weight_kind = old.weight_kind;
+    h.alive_offset = old.alive_offset;
+    h.parent_offset = old.parent_offset;
+    h.weight_offset = old.weight_offset;
+    h.depth_offset = old.depth_offset;
+    h.lift_offset = old.lift_offset;
+    h.file_size = old.file_size;
+    h.codec_offset = old.codec_offset;
+    h.codec_count = old.codec_count;
+    h.label_offset = old.label_offset;
+    return h;
+}
+
+/**
+ * Contenu des tableaux projetés cohérent avec n : parents dans [-1, n), label permutation de [0, n),
+ * profondeurs dans [-1, 2^levels), et pour chaque case lift[k][x] d'un sommet de l'arbre : up = -1 si
+ * depth[x] < 2^k, sinon un sommet de profondeur depth[x] - 2^k. Les sauts de LiftingView (scalaire et
+ * SIMD) restent alors dans les tableaux, même sur un index modifié à la main. O(n · levels).
+ */
+bool contents_valid(const TreeIndexHeader& h, const Vertex* parent, const Vertex* depth, const LiftEntry* lift,
+                    const Vertex* label) {
+    const size_t n = static_cast<size_t>(h.n);
+    if (n > 0 && h.levels < 1) return false;
+    const uint64_t depth_limit = uint64_t{1} << h.levels;
+    for (size_t v = 0; v < n; ++v) {
+        if (parent[v] < -1 || parent[v] >= static_cast<int64_t>(n)) return false;
+        if (depth[v] < -1 || (depth[v] >= 0 && static_cast<uint64_t>(depth[v]) >= depth_limit)) return false;
+    }
+    if (label) {
+        std::vector<char> seen(n, 0);
+        for (size_t v = 0; v < n; ++v) {
+            const Vertex x = label[v];
+            if (x < 0 || static_cast<size_t>(x) >= n || seen[static_cast<size_t>(x)]) return false;
+            seen[static_cast<size_t>(x)] = 1;
+        }
+    }
+    for (int k = 0; k < h.levels; ++k) {
+        const LiftEntry* level = lift + static_cast<size_t>(k) * n;
+        for (size_t x = 0; x < n; ++x) {
+            if (depth[x] < 0) continue;
+            const Vertex up = level[x].up;
+            if (static_cast<uint64_t>(depth[x]) < (uint64_t{1} << k)) {
+                if (up != -1) return false;
+            } else if (up < 0 || static_cast<size_t>(up) >= n ||
+                       depth[static_cast<size_t>(up)] != depth[x] - (Vertex{1} << k)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+}  // namespace
+
+// Défini ici plutôt que dans Graph.cpp : l'écriture et la lecture du format restent dans le même fichier.
+bool Graph::save_index(const std::string& path, const WeightCodec& codec) const {
+    if (!center_valid_) return false;
+    const uint64_t n = cont.size();
+    if (lift_stride_ != n) return false;
+
+    TreeIndexHeader h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = TreeIndex::VERSION;
+    h.weight_size = sizeof(Weight);
+    h.vertex_size = sizeof(Vertex);
+    h.n = n;
+    h.levels = lift_levels_;
+    h.centre = centre_;
+    h.diameter_length = diameter_length_;
+    h.alive_offset = align_up(sizeof(TreeIndexHeader));
+    h.parent_offset = align_up(h.alive_offset + n);
+    h.weight_offset = align_up(h.parent_offset + n * sizeof(Vertex));
+    h.depth_offset = align_up(h.weight_offset + n * sizeof(Weight));
+    h.lift_offset = align_up(h.depth_offset + n * sizeof(Vertex));
+    h.weight_kind = static_cast<uint32_t>(WEIGHT_KIND);
+    h.codec_count = codec.table().size();
+    h.codec_offset = h.codec_count ? align_up(h.lift_offset + lift_.size() * sizeof(LiftEntry)) : 0;
+    h.file_size = h.codec_count ? h.codec_offset + h.codec_count * sizeof(double)
+                                : h.lift_offset + lift_.size() * sizeof(LiftEntry);
+    if (!label_.empty()) {
+        h.label_offset = align_up(h.file_size);
+        h.file_size = h.label_offset + n * sizeof(Vertex);
+    }
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    OutputBuffer ob(f);
+    uint64_t pos = 0;
+    ob.write_bytes(&h, sizeof(h));
+    pos += sizeof(h);
+    pad_to(ob, pos, h.alive_offset);
+    ob.write_bytes(alive.data(), n);
+    pos += n;
+    pad_to(ob, pos, h.parent_offset);
+    ob.write_bytes(parent_.data(), n * sizeof(Vertex));
+    pos += n * sizeof(Vertex);
+    pad_to(ob, pos, h.weight_offset);
+    ob.write_bytes(parent_edge_weight_.data(), n * sizeof(Weight));
+    pos += n * sizeof(Weight);
+    pad_to(ob, pos, h.depth_offset);
+    ob.write_bytes(depth_.data(), n * sizeof(Vertex));
+    pos += n * sizeof(Vertex);
+    pad_to(ob, pos, h.lift_offset);
+    ob.write_bytes(lift_.data(), lift_.size() * sizeof(LiftEntry));
+    pos += lift_.size() * sizeof(LiftEntry);
+    if (h.codec_count) {
+        pad_to(ob, pos, h.codec_offset);
+        ob.write_bytes(codec.table().data(), h.codec_count * sizeof(double));
+        pos += h.codec_count * sizeof(double);
+    }
+    if (h.label_offset) {
+        pad_to(ob, pos, h.label_offset);
+        ob.write_bytes(label_.data(), n * sizeof(Vertex));
+    }
+    ob.flush();
+    return static_cast<bool>(f);
+}
+
+std::optional<TreeIndex> TreeIndex::open(const std::string& path) {
+    auto file = MappedFile::open(path, false);
+    if (!file || file->size() < sizeof(TreeIndexHeader)) return std::nullopt;
+    TreeIndex idx(std::move(*file));
+    const char* base = idx.file_.data();
+    std::memcpy(&idx.header_, base, sizeof(TreeIndexHeader));
+    if (std::memcmp(idx.header_.magic, MAGIC, sizeof(MAGIC)) != 0) return std::nullopt;
+    if (idx.header_.version < 1 || idx.header_.version > VERSION) return std::nullopt;
+    if (idx.header_.version < 3) {
+        LegacyHeader old;
+        std::memcpy(&old, base, sizeof(LegacyHeader));
+        auto converted = from_legacy(old);
+        if (!converted) return std::nullopt;
+        idx.header_ = *converted;
+    }
+    const TreeIndexHeader& h = idx.header_;
+
+    if (h.weight_size != sizeof(Weight) || h.vertex_size != sizeof(Vertex)) return std::nullopt;
+    if (h.weight_kind != static_cast<uint32_t>(WEIGHT_KIND)) return std::nullopt;
+    constexpr int MAX_LEVELS = 8 * static_cast<int>(sizeof(Vertex)) - 1;
+    if (h.levels < 0 || h.levels > MAX_LEVELS || h.file_size != idx.file_.size()) return std::nullopt;
+    if (h.n > static_cast<uint64_t>(std::numeric_limits<Vertex>::max())) return std::nullopt;
+
+    const uint64_t n = h.n;
+    auto fits = [&](uint64_t offset, uint64_t bytes) {
+        return offset % ALIGNMENT == 0 && offset <= h.file_size && bytes <= h.file_size - offset;
+    };
+    if (!fits(h.alive_offset, n) || !fits(h.parent_offset, n * sizeof(Vertex)) ||
+        !fits(h.weight_offset, n * sizeof(Weight)) || !fits(h.depth_offset, n * sizeof(Vertex)) ||
+        !fits(h.lift_offset, static_cast<uint64_t>(h.levels) * n * sizeof(LiftEntry)))
+        return std::nullopt;
+    if (n > 0 && (h.centre < 0 || static_cast<uint64_t>(h.centre) >= n)) return std::nullopt;
+    if (h.diameter_length < 0 || static_cast<uint64_t>(h.diameter_length) > n) return std::nullopt;
+    if (h.codec_count > 0) {
+        if (!fits(h.codec_offset, h.codec_count * sizeof(double))) return std::nullopt;
+        const double* table = reinterpret_cast<const double*>(base + h.codec_offset);
+        auto codec = WeightCodec::from_table(std::vector<double>(table, table + h.codec_count));
+        if (!codec) return std::nullopt;
+        idx.codec_ = std::move(*codec);
+    }
+    if (h.label_offset != 0 && !fits(h.label_offset, n * sizeof(Vertex))) return std::nullopt;
+
+    idx.alive_ = base + h.alive_offset;
+    idx.parent_ = reinterpret_cast<const Vertex*>(base + h.parent_offset);
+    idx.parent_edge_weight_ = reinterpret_cast<const Weight*>(base + h.weight_offset);
+    idx.view_.depth = reinterpret_cast<const Vertex*>(base + h.depth_offset);
+    idx.view_.lift = reinterpret_cast<const LiftEntry*>(base + h.lift_offset);
+    idx.view_.label = h.label_offset ? reinterpret_cast<const Vertex*>(base + h.label_offset) : nullptr;
+    idx.view_.stride = static_cast<size_t>(n);
+    idx.view_.levels = h.levels;
+    if (!contents_valid(h, idx.parent_, idx.view_.depth, idx.view_.lift, idx.view_.label)) return std::nullopt;
+    return idx;
+}
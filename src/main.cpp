@@ -1,11 +1,31 @@
+#include "CompactGraph.h"
+#include "DynamicMst.h"
 #include "Graph.h"
+#include "HldTree.h"
 #include "ItinerariesTest.h"
+#include "QueryProtocol.h"
+#include "QueryServer.h"
+#include "QueryStream.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+#include "TreeIndex.h"
+#include "Workload.h"
+#include <atomic>
 #include <cassert>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
 
 static std::string out_basename(const std::string& in_path) {
     std::string name = in_path;
@@ -37,15 +57,149 @@ static int count_edges_to(const Graph& g, int u, int v) {
     return c;
 }
 
+/** Charge une fois l'arbre (.in, prétraité pour v2) ou l'index, puis appelle run(n, moteur v2 par lot, codec). */
+template <class Run>
+static int with_v2_engine(const std::string& in_path, const std::string& load_index, Run&& run) {
+    if (!load_index.empty()) {
+        auto index = TreeIndex::open(load_index);
+        if (!index) {
+            std::cerr << "Index invalide ou incompatible : " << load_index << "\n";
+            return 1;
+        }
+        std::cerr << "Index : " << load_index << ", n = " << index->num_vertices() << "\n";
+        return run(index->num_vertices(), [&](const auto& queries, auto& answers) {
+            index->answer_batch(queries.data(), queries.size(), answers.data());
+        }, index->codec());
+    }
+    auto test = ItinerariesTest::load_from_file(in_path);
+    if (!test) {
+        std::cerr << "Échec chargement " << in_path << "\n";
+        return 1;
+    }
+    test->release_input();  // seul l'arbre sert aux requêtes
+    Graph& tree = test->mutable_tree();
+    tree.compute_center_and_parent();
+    if (!tree.has_center()) {
+        std::cerr << "Erreur : compute_center_and_parent a échoué (graphe non connexe ?).\n";
+        return 1;
+    }
+    std::cerr << "Arbre : " << in_path << ", n = " << tree.num_vertices() << "\n";
+    const Graph& shared = tree;
+    // Un thread par lot : --stream a son propre étage de réponse, --serve un thread par connexion.
+    return run(shared.num_vertices(), [&](const auto& queries, auto& answers) { answers = shared.answer_batch(queries, 1); },
+               test->codec());
+}
+
+static std::atomic<bool> g_stop_server{false};
+
+extern "C" void stop_server(int) { g_stop_server.store(true); }
+
 int main(int argc, char** argv) {
-    if (argc >= 2) {
-        std::string path = argv[1];
-        std::string output_dir = (argc >= 3) ? argv[2] : "outputItineraries";
+    // --save-index f : écrit aussi l'arbre prétraité ; --load-index f : le relit au lieu de charger le graphe.
+    // --stats : rapport par phase (temps, compteurs matériels ; compteurs logiciels avec make STATS=1).
+    // --stream : requêtes lues sur l'entrée standard, réponses écrites au fil de l'eau.
+    // --serve s : serveur de requêtes sur la socket Unix s (arrêt par SIGINT / SIGTERM).
+    std::string save_index, load_index, serve_socket;
+    bool with_stats = false, with_stream = false;
+    int argi = 1;
+    while (argi < argc) {
+        const std::string opt = argv[argi];
+        if (opt == "--stats" || opt == "--stream") {
+            (opt == "--stats" ? with_stats : with_stream) = true;
+            ++argi;
+            continue;
+        }
+        if (argi + 1 >= argc) break;
+        if (opt == "--save-index")
+            save_index = argv[argi + 1];
+        else if (opt == "--load-index")
+            load_index = argv[argi + 1];
+        else if (opt == "--serve")
+            serve_socket = argv[argi + 1];
+        else
+            break;
+        argi += 2;
+    }
+
+    if (with_stream || !serve_socket.empty()) {
+        if (argi >= argc && load_index.empty()) {
+            std::cerr << (with_stream ? "--stream" : "--serve") << " : fichier .in ou --load-index requis\n";
+            return 1;
+        }
+        const std::string in_path = argi < argc ? argv[argi] : "";
+        if (with_stream)
+            return with_v2_engine(in_path, load_index, [](Vertex, const BatchEngine& engine, const WeightCodec& codec) {
+                const StreamStats st = run_query_stream(0, std::cout, engine, codec);
+                std::cerr << st.queries << " requêtes, " << st.batches << " lots\n";
+                return 0;
+            });
+        return with_v2_engine(in_path, load_index, [&](Vertex n, const BatchEngine& engine, const WeightCodec& codec) {
+            std::signal(SIGINT, stop_server);
+            std::signal(SIGTERM, stop_server);
+            const int workers = std::getenv("THREADS") ? std::atoi(std::getenv("THREADS")) : 0;
+            std::cerr << "Serveur : " << serve_socket << " (Ctrl-C pour arrêter)\n";
+            if (!serve_queries(serve_socket, n, engine, workers, g_stop_server, codec)) {
+                std::cerr << "Impossible d'ouvrir la socket " << serve_socket << "\n";
+                return 1;
+            }
+            std::cerr << "Serveur arrêté\n";
+            return 0;
+        });
+    }
+
+    if (argi < argc) {
+        std::string path = argv[argi];
+        std::string output_dir = (argi + 1 < argc) ? argv[argi + 1] : "outputItineraries";
+        std::string out_path = output_dir + "/" + out_basename(path);
+        std::optional<stats::Report> report;
+        if (with_stats) report.emplace();
+        if (!load_index.empty()) {
+            if (report) report->begin("chargement");
+            auto t0 = std::chrono::high_resolution_clock::now();
+            auto index = TreeIndex::open(load_index);
+            if (!index) {
+                std::cerr << "Index invalide ou incompatible : " << load_index << "\n";
+                return 1;
+            }
+            auto t1 = std::chrono::high_resolution_clock::now();
+            auto queries = ItinerariesTest::load_queries_from_file(path, index->num_vertices());
+            if (!queries) {
+                std::cerr << "Échec chargement " << path << "\n";
+                return 1;
+            }
+            if (report) report->end();
+            std::cout << "Fichier : " << path << "\n";
+            std::cout << "Index : " << load_index << " ouvert en "
+                      << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+            if (report) report->begin("v2 requêtes (index)");
+            ItinerariesTest::run_with_index(*index, *queries, std::cout, out_path);
+            if (report) {
+                report->end();
+                report->write(std::cout);
+            }
+            return 0;
+        }
+        if (report) report->begin("chargement");
         auto test = ItinerariesTest::load_from_file(path);
+        if (report) report->end();
         if (test) {
             std::cout << "Fichier : " << path << "\n";
-            std::string out_path = output_dir + "/" + out_basename(path);
+            const LoadStats& ls = test->load_stats();
+            std::cout << "Chargement : " << ls.bytes / 1e6 << " Mo lus en " << ls.parse_ms << " ms ("
+                      << ls.parse_mb_per_s() << " Mo/s), graphe en " << ls.build_ms << " ms\n";
+            if (!ls.mst.empty()) std::cout << "MST (" << ls.mst << ") : " << ls.mst_ms << " ms\n";
+            if (!save_index.empty()) {
+                Graph& tree = test->mutable_tree();
+                tree.compute_center_and_parent();
+                if (!tree.save_index(save_index, test->codec())) {
+                    std::cerr << "Échec écriture de l'index " << save_index << "\n";
+                    return 1;
+                }
+                std::cout << "Index : " << save_index << " écrit\n";
+            }
+            test->set_stats(report ? &*report : nullptr);
             test->run_and_compare_times(std::cout, out_path, nullptr);
+            if (report) report->write(std::cout);
             return 0;
         }
         std::cerr << "Échec chargement " << path << "\n";
@@ -75,18 +229,42 @@ int main(int argc, char** argv) {
         for (Vertex v : ordre_bfs) std::cout << v << " ";
         std::cout << "\n";
 
+        const CompactGraph csr = g.freeze();
+        std::cout << "CSR (freeze) : " << csr.num_edges() << " arêtes, DFS/BFS "
+                  << ((csr.dfs(0) == ordre_dfs && csr.bfs(0) == ordre_bfs) ? "identiques" : "différents") << "\n";
+
         std::cout << "\n--- Arbre couvrant minimal (MST) ---\n";
         Graph mst_k = g.kruskal();
         std::cout << "Kruskal :\n" << mst_k;
         Weight total_k = 0;
         for (const Edge& e : mst_k.get_edges()) total_k += std::get<2>(e);
-        std::cout << "Poids total Kruskal : " << total_k << "\n\n";
+        std::cout << "Poids total Kruskal : " << +total_k << "\n\n";
 
         Graph mst_p = g.prim(0);
         std::cout << "Prim(0) :\n" << mst_p;
         Weight total_p = 0;
         for (const Edge& e : mst_p.get_edges()) total_p += std::get<2>(e);
-        std::cout << "Poids total Prim : " << total_p << "\n\n";
+        std::cout << "Poids total Prim : " << +total_p << "\n\n";
+
+        Graph mst_b = g.boruvka(2);
+        Weight total_b = 0;
+        for (const Edge& e : mst_b.get_edges()) total_b += std::get<2>(e);
+        std::cout << "Borůvka (2 threads) : " << mst_b.get_edges().size() << " arêtes, poids total " << +total_b
+                  << (total_b == total_k ? " (OK)" : " [diff]") << "\n";
+
+        // Poids doublés, donc entiers : les variantes *_radix doivent retrouver le poids de Kruskal.
+        std::vector<Edge> doubled = g.get_edges();
+        for (Edge& e : doubled) std::get<2>(e) *= 2;
+        const Graph g_int = Graph::from_edges(g.num_vertices(), doubled);
+        auto total_of = [](const Graph& t) {
+            Weight s = 0;
+            for (const Edge& e : t.get_edges()) s += std::get<2>(e);
+            return s;
+        };
+        const Weight total_int = total_of(g_int.kruskal());
+        const bool ok_radix = g_int.freeze().has_integral_weights() && total_of(g_int.kruskal_radix()) == total_int &&
+                              total_of(g_int.prim_radix(0)) == total_int && g_int.prim_radix(0).num_edges() == 4;
+        std::cout << "Poids entiers (×2) : kruskal_radix / prim_radix " << (ok_radix ? "(OK)" : "[diff]") << "\n\n";
 
         g.write_dot_file("output/graph.dot", "Demo");
         mst_p.write_dot_file("output/mst_prim.dot", "MST_Prim");
@@ -97,13 +275,13 @@ int main(int argc, char** argv) {
         auto m2 = mst_p.itineraries_v1(0, 3);
         auto m3 = mst_p.itineraries_v1(1, 4);
         auto m_same = mst_p.itineraries_v1(0, 0);
-        if (m1) std::cout << "itineraries_v1(0, 2) = " << *m1 << "\n";
+        if (m1) std::cout << "itineraries_v1(0, 2) = " << +*m1 << "\n";
         else    std::cout << "itineraries_v1(0, 2) = (non connectés)\n";
-        if (m2) std::cout << "itineraries_v1(0, 3) = " << *m2 << "\n";
+        if (m2) std::cout << "itineraries_v1(0, 3) = " << +*m2 << "\n";
         else    std::cout << "itineraries_v1(0, 3) = (non connectés)\n";
-        if (m3) std::cout << "itineraries_v1(1, 4) = " << *m3 << "\n";
+        if (m3) std::cout << "itineraries_v1(1, 4) = " << +*m3 << "\n";
         else    std::cout << "itineraries_v1(1, 4) = (non connectés)\n";
-        if (m_same) std::cout << "itineraries_v1(0, 0) = " << *m_same << " (chemin vide)\n";
+        if (m_same) std::cout << "itineraries_v1(0, 0) = " << +*m_same << " (chemin vide)\n";
         else        std::cout << "itineraries_v1(0, 0) = (non connectés)\n";
 
         std::cout << "\n--- Centre, parent, LCA (arbre MST) ---\n";
@@ -112,7 +290,7 @@ int main(int argc, char** argv) {
             std::cout << "Centre (racine) : " << mst_p.get_center() << "\n";
             std::cout << "Diamètre (nombre d'arêtes) : " << mst_p.get_diameter_length() << "\n";
             std::cout << "Parent : ";
-            for (int i = 0; i < mst_p.num_vertices(); ++i)
+            for (Vertex i = 0; i < mst_p.num_vertices(); ++i)
                 if (mst_p.is_alive(i))
                     std::cout << "parent[" << i << "]=" << mst_p.get_parent(i) << " ";
             std::cout << "\n";
@@ -124,22 +302,22 @@ int main(int argc, char** argv) {
             if (l3) std::cout << "LCA(3, 3) = " << *l3 << "\n";
             auto r1 = mst_p.max_on_path_to_ancestor(2, 0);
             auto r2 = mst_p.max_on_path_to_ancestor(4, 0);
-            if (r1) std::cout << "max_on_path_to_ancestor(2, 0) = " << *r1 << "\n";
-            if (r2) std::cout << "max_on_path_to_ancestor(4, 0) = " << *r2 << "\n";
+            if (r1) std::cout << "max_on_path_to_ancestor(2, 0) = " << +*r1 << "\n";
+            if (r2) std::cout << "max_on_path_to_ancestor(4, 0) = " << +*r2 << "\n";
 
             std::cout << "\n--- Test itineraries_v2 (vs itineraries_v1) ---\n";
             bool ok = true;
-            for (int u = 0; u < mst_p.num_vertices(); ++u) {
+            for (Vertex u = 0; u < mst_p.num_vertices(); ++u) {
                 if (!mst_p.is_alive(u)) continue;
-                for (int v = 0; v < mst_p.num_vertices(); ++v) {
+                for (Vertex v = 0; v < mst_p.num_vertices(); ++v) {
                     if (!mst_p.is_alive(v)) continue;
                     auto old_val = mst_p.itineraries_v1(u, v);
                     auto new_val = mst_p.itineraries_v2(u, v);
                     if (old_val != new_val) {
                         std::cout << "  Différence (" << u << "," << v << "): v1=";
-                        if (old_val) std::cout << *old_val; else std::cout << "null";
+                        if (old_val) std::cout << +*old_val; else std::cout << "null";
                         std::cout << " v2=";
-                        if (new_val) std::cout << *new_val; else std::cout << "null";
+                        if (new_val) std::cout << +*new_val; else std::cout << "null";
                         std::cout << "\n";
                         ok = false;
                     }
@@ -147,6 +325,73 @@ int main(int argc, char** argv) {
             }
             if (ok) std::cout << "  OK : itineraries_v1 et itineraries_v2 coïncident.\n";
 
+            std::vector<std::pair<Vertex, Vertex>> all_pairs;
+            for (Vertex u = 0; u < mst_p.num_vertices(); ++u)
+                for (Vertex v = 0; v < mst_p.num_vertices(); ++v) all_pairs.emplace_back(u, v);
+            all_pairs.emplace_back(-1, 0);  // hors bornes : nullopt aussi dans le noyau SIMD
+            all_pairs.emplace_back(0, mst_p.num_vertices());
+            // Au moins 8 requêtes par thread (au lieu de MIN_QUERIES_PER_THREAD) : le petit lot passe
+            // vraiment par plusieurs threads du pool.
+            auto batch = mst_p.answer_batch(all_pairs, 4, BatchOrder::Auto, 8);
+            bool ok_batch = ThreadPool::shared().size() >= 1 && batch == mst_p.answer_batch(all_pairs, 1);
+            // Deux appelants à la fois : leurs blocs passent par la même file du pool.
+            std::vector<std::optional<Weight>> concurrent[2];
+            std::thread other([&] { concurrent[1] = mst_p.answer_batch(all_pairs, 4, BatchOrder::Auto, 8); });
+            concurrent[0] = mst_p.answer_batch(all_pairs, 4, BatchOrder::Auto, 8);
+            other.join();
+            ok_batch = ok_batch && concurrent[0] == batch && concurrent[1] == batch;
+            for (size_t i = 0; i < all_pairs.size(); ++i)
+                if (batch[i] != mst_p.itineraries_v2(all_pairs[i].first, all_pairs[i].second)) ok_batch = false;
+            std::cout << "  answer_batch (4 threads, pool de " << ThreadPool::shared().size() << ", noyau "
+                      << LiftingView::batch_kernel_name() << ") : " << (ok_batch ? "OK" : "différent de itineraries_v2") << "\n";
+
+            const std::string index_path = "output/demo.idx";
+            bool ok_index = mst_p.save_index(index_path);
+            if (auto index = ok_index ? TreeIndex::open(index_path) : std::nullopt) {
+                ok_index = index->get_center() == mst_p.get_center();
+                for (size_t i = 0; i < all_pairs.size(); ++i)
+                    if (index->itineraries_v2(all_pairs[i].first, all_pairs[i].second) != batch[i]) ok_index = false;
+            } else {
+                ok_index = false;
+            }
+            std::cout << "  index sauvegardé puis relu (" << index_path << ") : "
+                      << (ok_index ? "OK" : "différent de itineraries_v2") << "\n";
+            // Index altéré (un ancêtre hors bornes) : open le refuse au lieu de lire hors des tableaux.
+            bool ok_corrupt = false;
+            {
+                std::fstream f(index_path, std::ios::in | std::ios::out | std::ios::binary);
+                TreeIndexHeader h{};
+                if (f.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+                    const Vertex bad = static_cast<Vertex>(h.n);
+                    f.seekp(static_cast<std::streamoff>(h.lift_offset + offsetof(LiftEntry, up)));
+                    ok_corrupt = static_cast<bool>(f.write(reinterpret_cast<const char*>(&bad), sizeof(bad)));
+                }
+            }
+            ok_corrupt = ok_corrupt && !TreeIndex::open(index_path);
+            std::cout << "  index altéré refusé par TreeIndex::open : " << (ok_corrupt ? "OK" : "accepté") << "\n";
+
+            // Tables renumérotées en préordre : mêmes réponses et mêmes LCA en identifiants d'origine, index compris.
+            Graph relabeled = mst_p;
+            relabeled.compute_center_and_parent(TreeLayout::Preorder);
+            bool ok_layout = relabeled.answer_batch(all_pairs, 1) == batch;
+            for (const auto& [u, v] : all_pairs)
+                if (u >= 0 && v < mst_p.num_vertices() && relabeled.lca(u, v) != mst_p.lca(u, v)) ok_layout = false;
+            const std::string preorder_path = "output/demo_preorder.idx";
+            if (auto index = relabeled.save_index(preorder_path) ? TreeIndex::open(preorder_path) : std::nullopt) {
+                std::vector<std::optional<Weight>> from_index(all_pairs.size());
+                index->answer_batch(all_pairs.data(), all_pairs.size(), from_index.data());
+                ok_layout = ok_layout && from_index == batch;
+            } else {
+                ok_layout = false;
+            }
+            std::cout << "  tables en préordre (TreeLayout::Preorder) : "
+                      << (ok_layout ? "OK" : "différent de itineraries_v2") << "\n";
+            // Lot exécuté dans l'ordre de la courbe en Z : réponses rendues dans l'ordre des requêtes.
+            bool ok_order = relabeled.answer_batch(all_pairs, 1, BatchOrder::Curve) == batch &&
+                            mst_p.answer_batch(all_pairs, 1, BatchOrder::Curve) == batch;
+            std::cout << "  lot trié en Z (BatchOrder::Curve) : "
+                      << (ok_order ? "OK" : "différent de itineraries_v2") << "\n";
+
             std::vector<std::pair<Vertex, Vertex>> qs = {{0, 2}, {1, 4}, {3, 3}, {2, 4}};
             auto tarjan_ans = mst_p.tarjan_lca(qs);
             std::cout << "\n--- Tarjan LCA (hors-ligne) ---\n";
@@ -159,9 +404,9 @@ int main(int argc, char** argv) {
 
             std::cout << "\n--- Itineraries v3 ---\n";
             std::vector<std::pair<Vertex, Vertex>> P;
-            for (int u = 0; u < mst_p.num_vertices(); ++u)
+            for (Vertex u = 0; u < mst_p.num_vertices(); ++u)
                 if (mst_p.is_alive(u))
-                    for (int v = u; v < mst_p.num_vertices(); ++v)
+                    for (Vertex v = u; v < mst_p.num_vertices(); ++v)
                         if (mst_p.is_alive(v))
                             P.emplace_back(u, v);
             mst_p.preprocess_itineraries_v3(P);
@@ -173,8 +418,183 @@ int main(int argc, char** argv) {
                 if (ref_w != tab_w) ok_final = false;
             }
             std::cout << "Réponses en O(1) en moyenne : " << (ok_final ? "toutes cohérentes avec itineraries_v1.\n" : "erreur.\n");
-            std::cout << "Exemples itineraries_v3(0,2) = " << *mst_p.itineraries_v3(0, 2)
-                      << ", itineraries_v3(1,4) = " << *mst_p.itineraries_v3(1, 4) << "\n";
+            std::cout << "Exemples itineraries_v3(0,2) = " << +*mst_p.itineraries_v3(0, 2)
+                      << ", itineraries_v3(1,4) = " << +*mst_p.itineraries_v3(1, 4) << "\n";
+
+            std::cout << "\n--- Itineraries v4 (arbre de reconstruction de Kruskal) ---\n";
+            g.preprocess_itineraries_v4();
+            bool ok_v4 = true;
+            for (const auto& [u, v] : P) {
+                if (g.itineraries_v4(u, v) != mst_p.itineraries_v1(u, v)) ok_v4 = false;
+            }
+            std::cout << "Sur le graphe d'origine (sans MST) : "
+                      << (ok_v4 ? "toutes cohérentes avec itineraries_v1.\n" : "erreur.\n");
+
+            std::cout << "\n--- Itineraries v5 (tour eulérien + sparse table, O(1)) ---\n";
+            g.preprocess_itineraries_v5();
+            bool ok_v5 = true;
+            for (const auto& [u, v] : P) {
+                if (g.itineraries_v5(u, v) != mst_p.itineraries_v1(u, v)) ok_v5 = false;
+            }
+            std::cout << "Sur le graphe d'origine (sans MST) : "
+                      << (ok_v5 ? "toutes cohérentes avec itineraries_v1.\n" : "erreur.\n");
+
+            std::cout << "\n--- MST dynamique (link-cut tree) ---\n";
+            DynamicMst dyn = DynamicMst::from_graph(g);
+            bool ok_dyn = dyn.total_weight() == total_k;
+            for (const auto& [u, v] : P)
+                if (dyn.query(u, v) != mst_p.itineraries_v1(u, v)) ok_dyn = false;
+            Graph g_plus = g;
+            g_plus.add_edge(1, 3, 0.5);
+            const bool swapped = dyn.insert_edge(1, 3, 0.5);
+            g_plus.preprocess_itineraries_v4();
+            for (const auto& [u, v] : P)
+                if (dyn.query(u, v) != g_plus.itineraries_v4(u, v)) ok_dyn = false;
+            std::cout << "Insertion de (1, 3, 0.5) : " << (swapped ? "arête échangée" : "MST inchangé")
+                      << ", poids total " << +dyn.total_weight() << " ; requêtes "
+                      << (ok_dyn ? "cohérentes avec itineraries_v1 puis v4 (graphe complété).\n" : "erreur.\n");
+
+            std::cout << "\n--- Poids modifiables (heavy-light + arbre de segments) ---\n";
+            HldTree hld = HldTree::from_graph(g);
+            bool ok_hld = hld.total_weight() == total_k;
+            for (const auto& [u, v] : P)
+                if (hld.query(u, v) != mst_p.itineraries_v1(u, v)) ok_hld = false;
+            Graph g_mod = g;
+            auto update = [&](Vertex u, Vertex v, Weight w) {
+                g_mod.delete_edge(u, v);
+                g_mod.add_edge(u, v, w);
+                const bool swapped = hld.update_edge_weight(u, v, w) == HldTree::Update::Swapped;
+                g_mod.preprocess_itineraries_v4();
+                for (const auto& [a, b] : P)
+                    if (hld.query(a, b) != g_mod.itineraries_v4(a, b)) ok_hld = false;
+                std::cout << "(" << u << ", " << v << ") → " << +w << " : " << (swapped ? "arête échangée" : "MST inchangé")
+                          << ", poids total " << +hld.total_weight() << "\n";
+            };
+            update(0, 1, 3.0);  // arête du MST alourdie : (4, 2) traverse la coupe
+            update(2, 3, 0.5);  // arête hors MST allégée : entre dans le cycle
+            update(1, 2, 0.25);
+            std::cout << "Requêtes " << (ok_hld ? "cohérentes avec itineraries_v1 puis v4 (graphe modifié).\n" : "erreur.\n");
+            {
+                // Forêt de deux arbres (redécomposition locale), mises à jour aléatoires comparées à une forêt
+                // de Kruskal recalculée : même poids total, mêmes max de chemin.
+                const int half = 300;
+                std::vector<Edge> cur = make_tree_edges(TreeShape::Random, half, 7, 200);
+                add_random_edges(cur, half, 3 * half, 8, 200);
+                for (const auto& [u, v, w] : make_tree_edges(TreeShape::Caterpillar, half, 9, 200)) cur.emplace_back(u + half, v + half, w);
+                for (auto& [u, v, w] : cur)
+                    if (u > v) std::swap(u, v);
+                std::sort(cur.begin(), cur.end(), [](const Edge& a, const Edge& b) {
+                    return std::make_pair(std::get<0>(a), std::get<1>(a)) < std::make_pair(std::get<0>(b), std::get<1>(b));
+                });
+                cur.erase(std::unique(cur.begin(), cur.end(), [](const Edge& a, const Edge& b) {
+                              return std::get<0>(a) == std::get<0>(b) && std::get<1>(a) == std::get<1>(b);
+                          }), cur.end());
+                HldTree live = HldTree::from_graph(Graph::from_edges(2 * half, cur));
+                const auto pairs = make_queries(2 * half, 200, 10);
+                WorkloadRng rng(11);
+                bool ok_live = true;
+                size_t swaps = 0;
+                for (int i = 1; i <= 2000 && ok_live; ++i) {
+                    auto& [u, v, w] = cur[static_cast<size_t>(rng.below(cur.size()))];
+                    w = static_cast<Weight>(1 + rng.below(200));
+                    if (live.update_edge_weight(u, v, w) == HldTree::Update::Swapped) ++swaps;
+                    if (i % 100) continue;
+                    const HldTree fresh = HldTree::from_graph(Graph::from_edges(2 * half, cur));
+                    ok_live = live.total_weight() == fresh.total_weight() && live.num_edges() == fresh.num_edges();
+                    for (const auto& [a, b] : pairs)
+                        if (live.query(a, b) != fresh.query(a, b)) ok_live = false;
+                }
+                std::cout << "2000 mises à jour aléatoires (" << swaps << " échanges) : "
+                          << (ok_live ? "forêt minimale, identique à Kruskal recalculé.\n" : "erreur.\n");
+            }
+
+            std::cout << "\n--- Types (include/Types.h) ---\n";
+            std::cout << "Weight : " << sizeof(Weight) << " octets ("
+                      << (WEIGHT_KIND == WeightKind::Rank ? "rang" : WEIGHT_KIND == WeightKind::Integer ? "entier" : "flottant")
+                      << "), Vertex : " << sizeof(Vertex) << " octets, LiftEntry : " << sizeof(LiftEntry) << " octets\n";
+            bool ok_codec = false;
+            if (auto codec = WeightCodec::from_values({40, 7, 12, 7, 25})) {
+                ok_codec = codec->table().size() == 5;  // 0, 7, 12, 25, 40
+                for (double x : {7.0, 12.0, 25.0, 40.0}) ok_codec = ok_codec && codec->decode(codec->encode(x)) == x;
+                ok_codec = ok_codec && codec->encode(12) < codec->encode(25) && codec->decode(0) == 0;
+            }
+            std::cout << "Table des rangs (WeightCodec) : " << (ok_codec ? "aller-retour et ordre OK\n" : "erreur\n");
+
+            std::cout << "\n--- Snapshots partagés (ItinerariesTest) ---\n";
+            ItinerariesTest test(mst_k, P);
+            std::shared_ptr<const Graph> snap = test.snapshot();
+            const bool shared = snap.get() == &test.graph();
+            test.mutable_tree().compute_center_and_parent();
+            const bool cow = &test.graph() != snap.get() && !snap->has_center() && test.graph().has_center();
+            snap.reset();
+            const Graph* before = &test.graph();
+            test.mutable_tree().preprocess_itineraries_v4();
+            const bool in_place = &test.graph() == before;
+            std::cout << "Snapshot partagé : " << (shared ? "oui" : "non") << ", copie à l'écriture : "
+                      << (cow ? "oui" : "non") << ", sans snapshot modifié sur place : "
+                      << (in_place ? "oui" : "non") << ((shared && cow && in_place) ? "\n" : " (erreur)\n");
+
+            std::cout << "\n--- Mode flux (--stream) ---\n";
+            int fds[2];
+            if (pipe(fds) == 0) {
+                std::string lines, expected;
+                for (const auto& [u, v] : P) {
+                    lines += std::to_string(u + 1) + " " + std::to_string(v + 1) + "\n";
+                    auto r = mst_p.itineraries_v2(u, v);
+                    expected += (r ? std::to_string(std::llround(*r)) : std::string("-1")) + "\n";
+                }
+                lines += "x\n";
+                expected += "-1\n";
+                const bool written = write(fds[1], lines.data(), lines.size()) == static_cast<ssize_t>(lines.size());
+                close(fds[1]);
+                std::ostringstream streamed;
+                const StreamStats st = run_query_stream(fds[0], streamed, [&](const auto& queries, auto& answers) {
+                    for (size_t i = 0; i < queries.size(); ++i)
+                        answers[i] = mst_p.itineraries_v2(queries[i].first, queries[i].second);
+                });
+                close(fds[0]);
+                std::cout << st.queries << " requêtes via un tube, réponses "
+                          << ((written && streamed.str() == expected) ? "identiques à itineraries_v2.\n" : "erreur.\n");
+            }
+
+            std::cout << "\n--- Serveur de requêtes (--serve) ---\n";
+            std::atomic<bool> stop{false};
+            const BatchEngine engine = [&](const auto& queries, auto& answers) {
+                for (size_t i = 0; i < queries.size(); ++i)
+                    answers[i] = mst_p.itineraries_v2(queries[i].first, queries[i].second);
+            };
+            std::thread server([&] { serve_queries("output/demo.sock", mst_p.num_vertices(), engine, 2, stop); });
+            bool ok_server = false;
+            for (int attempt = 0; attempt < 50 && !ok_server; ++attempt) {
+                const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un addr{};
+                addr.sun_family = AF_UNIX;
+                std::strcpy(addr.sun_path, "output/demo.sock");
+                if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+                    std::vector<protocol::QueryPair> pairs;
+                    for (const auto& [u, v] : P) pairs.push_back({static_cast<int64_t>(u), static_cast<int64_t>(v)});
+                    const protocol::RequestHeader req{protocol::REQUEST_MAGIC, static_cast<uint32_t>(pairs.size())};
+                    protocol::ResponseHeader resp{};
+                    std::vector<double> answers(pairs.size());
+                    if (protocol::write_full(fd, &req, sizeof(req)) &&
+                        protocol::write_full(fd, pairs.data(), pairs.size() * sizeof(pairs[0])) &&
+                        protocol::read_full(fd, &resp, sizeof(resp)) && resp.count == pairs.size() &&
+                        protocol::read_full(fd, answers.data(), answers.size() * sizeof(double))) {
+                        ok_server = true;
+                        for (size_t i = 0; i < P.size(); ++i) {
+                            auto r = mst_p.itineraries_v2(P[i].first, P[i].second);
+                            if (r ? answers[i] != *r : !std::isnan(answers[i])) ok_server = false;
+                        }
+                    }
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                if (fd >= 0) close(fd);
+            }
+            stop = true;
+            server.join();
+            std::cout << P.size() << " requêtes par socket Unix, réponses "
+                      << (ok_server ? "identiques à itineraries_v2.\n" : "erreur.\n");
         }
     }
 
@@ -0,0 +1,222 @@
+// Générateur de fichiers .in (make gen) : n m, m arêtes « u v c » (1-indexées), Q, Q paires.
+//
+// Tout est produit au fil de l'eau dans un OutputBuffer : aucune arête n'est stockée, seule l'option
+// --shuffle garde une permutation des sommets (4 octets par sommet). Même graine ⇒ même fichier.
+
+#include "OutputBuffer.h"
+#include "Workload.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class WeightDist { Uniform, Ties, LogUniform };
+enum class QuerySkew { Uniform, Zipf, Local };
+
+struct Options {
+    Vertex n = 100000;
+    long long m = -1;  // défaut : n - 1 (arbre)
+    TreeShape shape = TreeShape::Random;
+    WeightDist weights = WeightDist::Uniform;
+    long long max_weight = 100000;
+    long long queries = 100000;
+    QuerySkew skew = QuerySkew::Uniform;
+    double zipf_s = 1.1;
+    int hot_pairs = 1024;
+    int window = 64;
+    bool shuffle = false;
+    uint64_t seed = 1;
+    std::string out;
+};
+
+long long draw_weight(const Options& opt, WorkloadRng& rng) {
+    switch (opt.weights) {
+    case WeightDist::Uniform: break;
+    case WeightDist::Ties: return 1 + static_cast<long long>(rng.below(16));
+    case WeightDist::LogUniform:
+        return std::min(opt.max_weight,
+                        static_cast<long long>(std::exp(rng.unit() * std::log(static_cast<double>(opt.max_weight)))));
+    }
+    return 1 + static_cast<long long>(rng.below(static_cast<uint64_t>(opt.max_weight)));
+}
+
+/** Tire Q paires selon la distribution demandée (Zipf : sur hot_pairs paires fixées d'avance). */
+class QuerySampler
+{
+public:
+    QuerySampler(const Options& opt, WorkloadRng& rng) : opt_(opt), rng_(rng) {
+        if (opt.skew != QuerySkew::Zipf) return;
+        const int k = std::max(1, opt.hot_pairs);
+        hot_.resize(static_cast<size_t>(k));
+        for (auto& p : hot_) p = uniform_pair();
+        cdf_.resize(static_cast<size_t>(k));
+        double acc = 0;
+        for (int i = 0; i < k; ++i) cdf_[static_cast<size_t>(i)] = acc += 1.0 / std::pow(i + 1, opt.zipf_s);
+        for (double& c : cdf_) c /= acc;
+    }
+
+    std::pair<Vertex, Vertex> next() {
+        switch (opt_.skew) {
+        case QuerySkew::Uniform: break;
+        case QuerySkew::Zipf: {
+            const size_t i = static_cast<size_t>(std::upper_bound(cdf_.begin(), cdf_.end(), rng_.unit()) - cdf_.begin());
+            return hot_[std::min(i, hot_.size() - 1)];
+        }
+        case QuerySkew::Local: {
+            // Étiquettes voisines (avant --shuffle) : proches dans l'arbre pour path, caterpillar et balanced.
+            const long long u = static_cast<long long>(rng_.below(static_cast<uint64_t>(opt_.n)));
+            const long long off = static_cast<long long>(rng_.below(2 * static_cast<uint64_t>(opt_.window) + 1)) - opt_.window;
+            const long long v = std::clamp(u + off, 0LL, static_cast<long long>(opt_.n - 1));
+            return {static_cast<Vertex>(u), static_cast<Vertex>(v)};
+        }
+        }
+        return uniform_pair();
+    }
+
+private:
+    std::pair<Vertex, Vertex> uniform_pair() {
+        const auto u = static_cast<Vertex>(rng_.below(static_cast<uint64_t>(opt_.n)));
+        const auto v = static_cast<Vertex>(rng_.below(static_cast<uint64_t>(opt_.n)));
+        return {u, v};
+    }
+
+    const Options& opt_;
+    WorkloadRng& rng_;
+    std::vector<std::pair<Vertex, Vertex>> hot_;
+    std::vector<double> cdf_;
+};
+
+void generate(const Options& opt, std::ostream& os) {
+    WorkloadRng rng(opt.seed);
+    std::vector<Vertex> label;
+    if (opt.shuffle) {
+        label.resize(static_cast<size_t>(opt.n));
+        std::iota(label.begin(), label.end(), 0);
+        for (size_t i = label.size(); i > 1; --i) std::swap(label[i - 1], label[rng.below(i)]);
+    }
+    auto id = [&](Vertex v) -> long long { return (opt.shuffle ? label[static_cast<size_t>(v)] : v) + 1; };
+
+    OutputBuffer ob(os);
+    auto edge = [&](Vertex u, Vertex v) {
+        ob.write_int(id(u));
+        ob.put(' ');
+        ob.write_int(id(v));
+        ob.put(' ');
+        ob.write_int(draw_weight(opt, rng));
+        ob.put('\n');
+    };
+    ob.write_int(opt.n);
+    ob.put(' ');
+    ob.write_int(opt.m);
+    ob.put('\n');
+    generate_tree(opt.shape, opt.n, rng, edge);
+    for (long long i = opt.n - 1; i < opt.m; ++i) {
+        const auto u = static_cast<Vertex>(rng.below(static_cast<uint64_t>(opt.n)));
+        auto v = static_cast<Vertex>(rng.below(static_cast<uint64_t>(opt.n - 1)));
+        if (v >= u) ++v;
+        edge(u, v);
+    }
+
+    ob.write_int(opt.queries);
+    ob.put('\n');
+    QuerySampler sampler(opt, rng);
+    for (long long i = 0; i < opt.queries; ++i) {
+        const auto [u, v] = sampler.next();
+        ob.write_int(id(u));
+        ob.put(' ');
+        ob.write_int(id(v));
+        ob.put('\n');
+    }
+    ob.flush();
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    double density = -1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--shuffle") {
+            opt.shuffle = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const std::string val = argv[++i];
+        if (a == "--n")
+            opt.n = static_cast<Vertex>(std::atoll(val.c_str()));
+        else if (a == "--m")
+            opt.m = std::atoll(val.c_str());
+        else if (a == "--density")
+            density = std::atof(val.c_str());
+        else if (a == "--shape") {
+            auto s = parse_shape(val);
+            if (!s) return false;
+            opt.shape = *s;
+        } else if (a == "--weights") {
+            if (val == "uniform") opt.weights = WeightDist::Uniform;
+            else if (val == "ties") opt.weights = WeightDist::Ties;
+            else if (val == "loguniform") opt.weights = WeightDist::LogUniform;
+            else return false;
+        } else if (a == "--max-weight")
+            opt.max_weight = std::atoll(val.c_str());
+        else if (a == "--queries")
+            opt.queries = std::atoll(val.c_str());
+        else if (a == "--skew") {
+            if (val == "uniform") opt.skew = QuerySkew::Uniform;
+            else if (val == "zipf") opt.skew = QuerySkew::Zipf;
+            else if (val == "local") opt.skew = QuerySkew::Local;
+            else return false;
+        } else if (a == "--zipf-s")
+            opt.zipf_s = std::atof(val.c_str());
+        else if (a == "--hot-pairs")
+            opt.hot_pairs = std::atoi(val.c_str());
+        else if (a == "--window")
+            opt.window = std::atoi(val.c_str());
+        else if (a == "--seed")
+            opt.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else if (a == "--out")
+            opt.out = val;
+        else
+            return false;
+    }
+    if (opt.n < 2 || opt.max_weight < 1 || opt.queries < 0 || opt.window < 0) return false;
+    if (density >= 0) opt.m = static_cast<long long>(density * opt.n);
+    if (opt.m < 0) opt.m = opt.n - 1;
+    // Le chargeur lit m et Q dans un int ; l'arbre couvrant est toujours émis en entier.
+    return opt.m >= opt.n - 1 && opt.m <= std::numeric_limits<EdgeIndex>::max() && opt.queries <= 0x7fffffff;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::cerr << "Usage : gen_itineraries [--n N] [--m M | --density D] [--shape path|star|random|caterpillar|balanced]\n"
+                     "                       [--weights uniform|ties|loguniform] [--max-weight W]\n"
+                     "                       [--queries Q] [--skew uniform|zipf|local] [--zipf-s S] [--hot-pairs K]\n"
+                     "                       [--window L] [--shuffle] [--seed S] [--out fichier.in]\n"
+                     "  m ≥ n-1 : arbre de la forme choisie puis m-n+1 arêtes aléatoires.\n";
+        return 1;
+    }
+    if (opt.out.empty()) {
+        std::ios::sync_with_stdio(false);
+        generate(opt, std::cout);
+        return std::cout ? 0 : 1;
+    }
+    std::ofstream f(opt.out, std::ios::binary);
+    if (!f) {
+        std::cerr << "Échec ouverture " << opt.out << "\n";
+        return 1;
+    }
+    generate(opt, f);
+    if (!f) {
+        std::cerr << "Échec écriture " << opt.out << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+// Client du serveur de requêtes (./output/main --serve s …) : test de charge ou requêtes lues sur stdin.
+//
+// Charge : C connexions en parallèle, R requêtes de B paires aléatoires chacune ; latence par requête
+// (aller-retour complet), p50 / p99 / max, débit global en paires/s.
+// --stdin : lignes « u v » 1-indexées, une réponse par ligne au format .out (entier arrondi, -1).
+
+#include "QueryProtocol.h"
+#include "Workload.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string socket;
+    int clients = 1;
+    int batch = 64;
+    int requests = 1000;
+    uint64_t seed = 1;
+    bool from_stdin = false;
+};
+
+int connect_to(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/** Un aller-retour ; answers reçoit une valeur par paire. false si la connexion ou la réponse est invalide. */
+bool round_trip(int fd, const std::vector<protocol::QueryPair>& pairs, std::vector<double>& answers,
+                protocol::ResponseHeader& resp) {
+    const protocol::RequestHeader req{protocol::REQUEST_MAGIC, static_cast<uint32_t>(pairs.size())};
+    if (!protocol::write_full(fd, &req, sizeof(req)) ||
+        !protocol::write_full(fd, pairs.data(), pairs.size() * sizeof(protocol::QueryPair)))
+        return false;
+    if (!protocol::read_full(fd, &resp, sizeof(resp))) return false;
+    if (resp.magic != protocol::RESPONSE_MAGIC || resp.status != protocol::OK || resp.count != pairs.size())
+        return false;
+    answers.resize(resp.count);
+    return protocol::read_full(fd, answers.data(), answers.size() * sizeof(double));
+}
+
+void print_answers(const std::vector<double>& answers) {
+    for (double a : answers) {
+        if (std::isnan(a))
+            std::cout << "-1\n";
+        else
+            std::cout << std::llround(a) << "\n";
+    }
+}
+
+int run_stdin(const Options& opt) {
+    const int fd = connect_to(opt.socket);
+    if (fd < 0) {
+        std::cerr << "Connexion impossible : " << opt.socket << "\n";
+        return 1;
+    }
+    std::ios::sync_with_stdio(false);
+    std::vector<protocol::QueryPair> pairs;
+    std::vector<double> answers;
+    protocol::ResponseHeader resp{};
+    long long u = 0, v = 0;
+    bool ok = true;
+    while (ok && std::cin >> u >> v) {
+        pairs.push_back({static_cast<int64_t>(u - 1), static_cast<int64_t>(v - 1)});
+        if (pairs.size() == static_cast<size_t>(opt.batch)) {
+            ok = round_trip(fd, pairs, answers, resp);
+            if (ok) print_answers(answers);
+            pairs.clear();
+        }
+    }
+    if (ok && !pairs.empty()) {
+        ok = round_trip(fd, pairs, answers, resp);
+        if (ok) print_answers(answers);
+    }
+    close(fd);
+    if (!ok) std::cerr << "Réponse invalide du serveur\n";
+    return ok ? 0 : 1;
+}
+
+int run_load(const Options& opt) {
+    int64_t n = 0;
+    {
+        const int fd = connect_to(opt.socket);
+        std::vector<double> none;
+        protocol::ResponseHeader resp{};
+        if (fd < 0 || !round_trip(fd, {}, none, resp)) {
+            std::cerr << "Connexion impossible : " << opt.socket << "\n";
+            return 1;
+        }
+        close(fd);
+        n = resp.n_vertices;
+    }
+    if (n < 1) {
+        std::cerr << "Serveur sans sommets\n";
+        return 1;
+    }
+
+    std::vector<std::vector<double>> latencies(static_cast<size_t>(opt.clients));
+    std::vector<char> failed(static_cast<size_t>(opt.clients), 0);
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < opt.clients; ++c)
+        threads.emplace_back([&, c] {
+            const int fd = connect_to(opt.socket);
+            if (fd < 0) {
+                failed[static_cast<size_t>(c)] = 1;
+                return;
+            }
+            WorkloadRng rng(opt.seed + static_cast<uint64_t>(c));
+            std::vector<protocol::QueryPair> pairs(static_cast<size_t>(opt.batch));
+            std::vector<double> answers;
+            protocol::ResponseHeader resp{};
+            auto& lat = latencies[static_cast<size_t>(c)];
+            lat.reserve(static_cast<size_t>(opt.requests));
+            for (int r = 0; r < opt.requests; ++r) {
+                for (auto& p : pairs) {
+                    p.u = static_cast<int64_t>(rng.below(static_cast<uint64_t>(n)));
+                    p.v = static_cast<int64_t>(rng.below(static_cast<uint64_t>(n)));
+                }
+                const auto a = std::chrono::steady_clock::now();
+                if (!round_trip(fd, pairs, answers, resp)) {
+                    failed[static_cast<size_t>(c)] = 1;
+                    break;
+                }
+                const auto b = std::chrono::steady_clock::now();
+                lat.push_back(std::chrono::duration<double, std::micro>(b - a).count());
+            }
+            close(fd);
+        });
+    for (auto& t : threads) t.join();
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::vector<double> all;
+    for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    const long long failures = std::count(failed.begin(), failed.end(), 1);
+    if (all.empty()) {
+        std::cerr << "Aucune requête aboutie\n";
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double p) { return all[std::min(all.size() - 1, static_cast<size_t>(p * static_cast<double>(all.size())))]; };
+    const double pairs_total = static_cast<double>(all.size()) * opt.batch;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "n = " << n << ", " << opt.clients << " clients × " << opt.requests << " requêtes × " << opt.batch
+              << " paires\n";
+    std::cout << "latence (µs) : p50 " << pct(0.50) << ", p99 " << pct(0.99) << ", max " << all.back() << "\n";
+    std::cout << "débit : " << all.size() / wall_s << " requêtes/s, " << pairs_total / wall_s << " paires/s\n";
+    if (failures) std::cout << failures << " client(s) en échec\n";
+    return failures ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    bool ok = true;
+    for (int i = 1; i < argc && ok; ++i) {
+        const std::string a = argv[i];
+        if (a == "--stdin") {
+            opt.from_stdin = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            ok = false;
+            break;
+        }
+        const std::string val = argv[++i];
+        if (a == "--socket")
+            opt.socket = val;
+        else if (a == "--clients")
+            opt.clients = std::atoi(val.c_str());
+        else if (a == "--batch")
+            opt.batch = std::atoi(val.c_str());
+        else if (a == "--requests")
+            opt.requests = std::atoi(val.c_str());
+        else if (a == "--seed")
+            opt.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else
+            ok = false;
+    }
+    if (!ok || opt.socket.empty() || opt.clients < 1 || opt.batch < 1 ||
+        static_cast<uint32_t>(opt.batch) > protocol::MAX_BATCH || opt.requests < 1) {
+        std::cerr << "Usage : itineraries_client --socket s [--clients C] [--batch B] [--requests R] [--seed S]\n"
+                     "        itineraries_client --socket s --stdin [--batch B]   (lignes « u v » 1-indexées)\n";
+        return 1;
+    }
+    return opt.from_stdin ? run_stdin(opt) : run_load(opt);
+}